@@ -0,0 +1,212 @@
+#include "AmountColumns.h"
+#include <climits>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace AmountKernels {
+
+#if defined(__AVX2__)
+
+    namespace {
+        int64_t horizontalSum(__m256i v) {
+            alignas(32) int64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+            return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        }
+    }
+
+    int64_t sum(const int64_t* values, size_t count) {
+        __m256i acc0 = _mm256_setzero_si256();
+        __m256i acc1 = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            acc0 = _mm256_add_epi64(acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)));
+            acc1 = _mm256_add_epi64(acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + 4)));
+        }
+        int64_t total = horizontalSum(_mm256_add_epi64(acc0, acc1));
+        for (; i < count; ++i) {
+            total += values[i];
+        }
+        return total;
+    }
+
+    int64_t sumInWindow(const int64_t* values, const int64_t* timestamps, size_t count, int64_t from, int64_t to) {
+        const __m256i lower = _mm256_set1_epi64x(from);
+        const __m256i upper = _mm256_set1_epi64x(to);
+        __m256i acc = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(timestamps + i));
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            // Lanes outside the window: from > t or t > to
+            __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(lower, t), _mm256_cmpgt_epi64(t, upper));
+            acc = _mm256_add_epi64(acc, _mm256_andnot_si256(outside, v));
+        }
+        int64_t total = horizontalSum(acc);
+        for (; i < count; ++i) {
+            if (timestamps[i] >= from && timestamps[i] <= to) {
+                total += values[i];
+            }
+        }
+        return total;
+    }
+
+    size_t countAtLeast(const int64_t* values, size_t count, int64_t threshold) {
+        const __m256i limit = _mm256_set1_epi64x(threshold);
+        __m256i below = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            // Comparison lanes are -1 where v < threshold
+            below = _mm256_sub_epi64(below, _mm256_cmpgt_epi64(limit, v));
+        }
+        size_t total = i - static_cast<size_t>(horizontalSum(below));
+        for (; i < count; ++i) {
+            if (values[i] >= threshold) {
+                ++total;
+            }
+        }
+        return total;
+    }
+
+    void filterAtLeast(const int64_t* values, size_t count, int64_t threshold, std::vector<uint32_t>& rows) {
+        // Every lane writes its row number and only kept lanes advance the output,
+        // so there is no branch on the data; the spare room is trimmed at the end
+        const __m256i limit = _mm256_set1_epi64x(threshold);
+        size_t base = rows.size();
+        rows.resize(base + count);
+        uint32_t* out = rows.data() + base;
+        size_t kept = 0;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            int keep = ~_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(limit, v)));
+            for (int lane = 0; lane < 4; ++lane) {
+                out[kept] = static_cast<uint32_t>(i + lane);
+                kept += (keep >> lane) & 1;
+            }
+        }
+        for (; i < count; ++i) {
+            out[kept] = static_cast<uint32_t>(i);
+            kept += values[i] >= threshold ? 1 : 0;
+        }
+        rows.resize(base + kept);
+    }
+
+    bool vectorized() {
+        return true;
+    }
+
+#else
+
+    int64_t sum(const int64_t* values, size_t count) {
+        int64_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            total += values[i];
+        }
+        return total;
+    }
+
+    int64_t sumInWindow(const int64_t* values, const int64_t* timestamps, size_t count, int64_t from, int64_t to) {
+        int64_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            // Branch-free select keeps the loop vectorizable
+            total += (timestamps[i] >= from && timestamps[i] <= to) ? values[i] : 0;
+        }
+        return total;
+    }
+
+    size_t countAtLeast(const int64_t* values, size_t count, int64_t threshold) {
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            total += values[i] >= threshold ? 1 : 0;
+        }
+        return total;
+    }
+
+    void filterAtLeast(const int64_t* values, size_t count, int64_t threshold, std::vector<uint32_t>& rows) {
+        for (size_t i = 0; i < count; ++i) {
+            if (values[i] >= threshold) {
+                rows.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    bool vectorized() {
+        return false;
+    }
+
+#endif
+
+}
+
+constexpr int64_t AmountColumns::scale;
+
+int64_t AmountColumns::toFixed(double value) {
+    return static_cast<int64_t>(std::llround(value * static_cast<double>(scale)));
+}
+
+double AmountColumns::toDouble(int64_t value) {
+    return static_cast<double>(value) / static_cast<double>(scale);
+}
+
+void AmountColumns::append(const TransactionNode& transaction) {
+    amounts.push_back(toFixed(transaction.amount));
+    fees.push_back(toFixed(transaction.fee));
+    timestamps.push_back(static_cast<int64_t>(transaction.timestamp));
+
+    auto inserted = accountIds.emplace(transaction.senderAcc, static_cast<uint32_t>(accountIds.size()));
+    senders.push_back(inserted.first->second);
+}
+
+size_t AmountColumns::memoryUsage() const {
+    size_t bytes = (amounts.capacity() + fees.capacity() + timestamps.capacity()) * sizeof(int64_t)
+        + senders.capacity() * sizeof(uint32_t);
+    bytes += accountIds.bucket_count() * sizeof(void*)
+        + accountIds.size() * (sizeof(std::pair<const std::string, uint32_t>) + sizeof(void*));
+    return bytes;
+}
+
+void AmountColumns::clear() {
+    amounts.clear();
+    fees.clear();
+    timestamps.clear();
+    senders.clear();
+    accountIds.clear();
+}
+
+int64_t AmountColumns::totalAmount() const {
+    return AmountKernels::sum(amounts.data(), amounts.size());
+}
+
+int64_t AmountColumns::totalFees() const {
+    return AmountKernels::sum(fees.data(), fees.size());
+}
+
+int64_t AmountColumns::volumeBetween(time_t from, time_t to) const {
+    return AmountKernels::sumInWindow(amounts.data(), timestamps.data(), amounts.size(),
+        static_cast<int64_t>(from), static_cast<int64_t>(to));
+}
+
+int64_t AmountColumns::feesBetween(time_t from, time_t to) const {
+    return AmountKernels::sumInWindow(fees.data(), timestamps.data(), fees.size(),
+        static_cast<int64_t>(from), static_cast<int64_t>(to));
+}
+
+size_t AmountColumns::countAmountAtLeast(int64_t threshold) const {
+    return AmountKernels::countAtLeast(amounts.data(), amounts.size(), threshold);
+}
+
+std::vector<uint32_t> AmountColumns::rowsWithAmountAtLeast(int64_t threshold) const {
+    std::vector<uint32_t> rows;
+    AmountKernels::filterAtLeast(amounts.data(), amounts.size(), threshold, rows);
+    return rows;
+}
+
+uint32_t AmountColumns::accountId(const std::string& account) const {
+    auto it = accountIds.find(account);
+    return it == accountIds.end() ? UINT32_MAX : it->second;
+}
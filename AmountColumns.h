@@ -0,0 +1,78 @@
+#ifndef AMOUNT_COLUMNS_H
+#define AMOUNT_COLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TransactionNode.h"
+
+// Aggregation kernels over plain int64 columns. Built with AVX2 when the
+// compiler targets it (XYLONET_ENABLE_AVX2), otherwise a scalar loop.
+// bench/AmountKernelsBench times them; run it from both builds to compare.
+namespace AmountKernels {
+    int64_t sum(const int64_t* values, size_t count);
+
+    // Sum of values whose timestamp lies in [from, to]
+    int64_t sumInWindow(const int64_t* values, const int64_t* timestamps, size_t count, int64_t from, int64_t to);
+
+    // Number of values >= threshold
+    size_t countAtLeast(const int64_t* values, size_t count, int64_t threshold);
+
+    // Row numbers of values >= threshold, appended to 'rows'
+    void filterAtLeast(const int64_t* values, size_t count, int64_t threshold, std::vector<uint32_t>& rows);
+
+    // True if this build uses the vectorized kernels
+    bool vectorized();
+}
+
+// Column-oriented copy of the numeric transaction fields, one row per node id.
+// Amounts and fees are fixed-point integers (millionths), so totals are exact
+// and scanning them never touches the heap-allocated TransactionNodes.
+class AmountColumns {
+public:
+    static constexpr int64_t scale = 1000000;
+
+    static int64_t toFixed(double value);
+    static double toDouble(int64_t value);
+
+    void append(const TransactionNode& transaction);
+    void clear();
+
+    size_t size() const { return amounts.size(); }
+
+    // Approximate heap bytes held by the columns and the account dictionary
+    size_t memoryUsage() const;
+
+    int64_t totalAmount() const;
+    int64_t totalFees() const;
+
+    // Amount moved by transactions with from <= timestamp <= to
+    int64_t volumeBetween(time_t from, time_t to) const;
+
+    // Fees collected by transactions with from <= timestamp <= to
+    int64_t feesBetween(time_t from, time_t to) const;
+
+    size_t countAmountAtLeast(int64_t threshold) const;
+    std::vector<uint32_t> rowsWithAmountAtLeast(int64_t threshold) const;
+
+    // Dictionary id of a sender account, or UINT32_MAX if never seen
+    uint32_t accountId(const std::string& account) const;
+
+    const std::vector<int64_t>& amountColumn() const { return amounts; }
+    const std::vector<int64_t>& feeColumn() const { return fees; }
+    const std::vector<int64_t>& timestampColumn() const { return timestamps; }
+    const std::vector<uint32_t>& senderColumn() const { return senders; }
+
+private:
+    std::vector<int64_t> amounts;
+    std::vector<int64_t> fees;
+    std::vector<int64_t> timestamps;
+    std::vector<uint32_t> senders;
+
+    std::unordered_map<std::string, uint32_t> accountIds;
+};
+
+#endif // AMOUNT_COLUMNS_H
@@ -11,8 +11,21 @@
 #include <random>
 #include <ctime>
 #include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include "TransactionNode.h"
 #include "HashUtils.h"
+#include "AmountColumns.h"
+#include "DAGPolicies.h"
+#include "DAGStatistics.h"
+#include "MemoryAccounting.h"
+#include "ReachabilityIndex.h"
+#include "TransactionArchive.h"
+#include "TransactionIndex.h"
+#include "TipSelectionEngine.h"
+#include "TransactionStore.h"
+#include "WeightSketches.h"
 #include <stdexcept>
 
 using namespace std;
@@ -28,6 +41,13 @@ struct TipInfo {
         : hash(h), cumulativeWeight(cWeight), timestamp(ts), amount(amt), fee(f) {}
 };
 
+// unordered_map whose node and bucket allocations are attributed to a memory subsystem
+template <typename Key, typename Value, MemorySubsystem Subsystem>
+using TrackedMap = std::unordered_map<Key, Value, std::hash<Key>, std::equal_to<Key>,
+    TrackedAllocator<std::pair<const Key, Value>, Subsystem>>;
+
+using TransactionMap = TrackedMap<std::string, TransactionNode, MemorySubsystem::Transactions>;
+
 template <typename T>
 class Stack {
 private:
@@ -63,25 +83,113 @@ public:
     }
 };
 
-class DAG {
+// Runtime knobs for depth-bounded tip selection. Depth is 0 for a transaction
+// without known parents and 1 + the deepest parent otherwise.
+struct WalkConfig {
+    uint32_t entryDepth = 15;  // Walks start this many levels below the deepest transaction
+    uint32_t maxTipAge = 50;   // Unconfirmed transactions further below are lazy and not approved
+    double alpha = 0.0;        // Bias toward heavier approvers; 0 walks uniformly
+    size_t maxSteps = 1000;    // Safety bound on a single walk
+};
+
+// How consensus weighs a transaction. Exact runs the WeightPolicy recursion over
+// approvers on every pass; Approximate keeps a HyperLogLog sketch per node and
+// uses the estimated future cone size (counting the node itself).
+enum class WeightMode {
+    Exact,
+    Approximate
+};
+
+// The tangle, parameterized at compile time by a policy bundle (see DAGPolicies.h).
+// Member definitions live in DAG.tpp, included below, so any bundle can be
+// instantiated where it is used; DAG.cpp only instantiates the default bundle.
+template <typename Policies = DefaultDAGPolicies>
+class BasicDAG {
 private:
-    std::unordered_map<std::string, std::vector<std::string>> adjList;      
-    unordered_map<string, TransactionNode> transactions;   
-    unordered_map<string, int> cumulativeWeights;           
+    using TipSelector = typename Policies::TipSelector;
+    using WeightPolicy = typename Policies::WeightPolicy;
+    using FeePolicy = typename Policies::FeePolicy;
+
+    using ApproverMap = TrackedMap<std::string, std::vector<std::string>, MemorySubsystem::Approvers>;
+    using WeightMap = TrackedMap<std::string, int, MemorySubsystem::Weights>;
+
+    // Allocation counters for the tracked maps below; declared first so it outlives them
+    MemoryCounters memoryCounters;
+
+    ApproverMap adjList{ ApproverMap::allocator_type(&memoryCounters) };
+    TransactionMap transactions{ TransactionMap::allocator_type(&memoryCounters) };
+    WeightMap cumulativeWeights{ WeightMap::allocator_type(&memoryCounters) };
+
+    // Current tips (transactions without approvers), kept as a vector for O(1) random picks
+    std::vector<std::string> tipList;
+    std::unordered_map<std::string, size_t> tipPositions;
+
+    // Random source for tip selection; seeded explicitly so runs are reproducible
+    std::mt19937_64 rng;
+
+    // Whether per-transaction progress is written to stdout
+    bool verbose = true;
+
+    // Dense ids in attach order, used by the index structures below
+    std::vector<std::string> nodeHashes;
+    std::unordered_map<std::string, uint32_t> nodeIds;
+
+    // Answers "does A approve B" without walking parentHashes
+    ReachabilityIndex reachability;
 
-    // Helper function to check for cycles in the DAG
-    bool hasCycle(const std::string& node,
-        std::unordered_set<std::string>& visited,
-        Stack<std::string>& stack);
+    // Time-ordered and per-account lookups for range queries
+    TransactionIndex secondaryIndex;
 
+    // Fixed-point amount, fee, timestamp and sender columns for reporting scans
+    AmountColumns amountColumns;
+
+    // Checkpoint state: frozen nodes are confirmed history that consensus no longer revisits
+    static constexpr uint8_t frozenMark = 1;      // Confirmed and below the checkpoint
+    static constexpr uint8_t retiredMark = 2;     // Lazy tip passed by the checkpoint, never confirmed
+    std::vector<uint8_t> frozen;                  // node id -> 0 while live, else one of the marks above
+    size_t liveStart = 0;                         // Lowest node id that may still be live
+    size_t frozenCount = 0;
+    std::vector<std::string> checkpointFrontier;  // Frozen nodes without frozen approvers
+    uint32_t frontierFloor = 0;                   // Shallowest frontier depth; walks never enter below it
+
+    // Depth per node id and node ids per depth, for choosing walk entry points
+    std::vector<uint32_t> depths;
+    std::vector<std::vector<uint32_t>> depthBuckets;
+    WalkConfig walkConfig;
+
+    WeightMode weightMode = WeightMode::Exact;
+    WeightSketches sketches;                      // Maintained only in Approximate mode
+
+    // Shape and health figures, updated on attach, tip changes, confirmation and retirement
+    DAGStatistics statistics;
+
+    // Frozen history older than the newest hotWindow node ids lives in coldStore, if set
+    std::unique_ptr<TransactionStore> coldStore;
+    size_t hotWindow = 0;
+    size_t coldStart = 0;                         // Node ids below this have been moved out
 
     // Recursive function to update cumulative weights for each transaction
     int updateCumulativeWeights(const string& hash);
 
+    // Helpers to keep the tip list and approver lists in sync with transactions
+    void addTip(const std::string& hash);
+    void removeTip(const std::string& hash);
+    void rebuildIndexes();
+    void indexTransaction(const TransactionNode& transaction);
+    void freezeNode(uint32_t id);
+    bool saveCheckpoint(const std::string& filename) const;
+    bool loadCheckpoint(const std::string& filename);
+    bool hasLiveApprover(const std::string& hash) const;
+    void evictColdTransactions();
+    void rebuildSketches();
+    void restoreColdTransactions();
+    void updateFrontierFloor();
+    uint32_t walkEntryLevel() const;
+
 public:
     // Constructor and Destructor
-    DAG() = default;
-    ~DAG() = default;
+    BasicDAG() = default;
+    ~BasicDAG() = default;
 
     // Function to select parents using Markov Chain Monte Carlo (MCMC) method
     vector<string> selectParentsMCMC(size_t numParents = 2);
@@ -89,19 +197,146 @@ public:
     bool validateTransaction(const std::string& hash, double validationThreshold, std::unordered_set<std::string>& visited);
     bool addTransaction(TransactionNode& transaction);
 
+    // Attach a transaction using the parents already stored in transaction.parentHashes.
+    // Every parent must already be attached; otherwise nothing changes and false is returned.
+    bool attachTransaction(TransactionNode& transaction);
+
+    // Seed the tip selection random source
+    void seedRandom(uint64_t seed) { rng.seed(seed); }
+
+    // Enable or disable per-transaction console output
+    void setVerbose(bool enabled) { verbose = enabled; }
+
+    // Number of transactions not yet approved by any other transaction
+    size_t tipCount() const { return tipList.size(); }
+
+    const std::vector<std::string>& getTips() const { return tipList; }
+
+    void setWalkConfig(const WalkConfig& config) {
+        walkConfig = config;
+        statistics.setMaxTipAge(config.maxTipAge);
+    }
+    const WalkConfig& getWalkConfig() const { return walkConfig; }
+
+    // Depth of the given transaction (0 if unknown) and of the deepest transaction
+    uint32_t depthOf(const std::string& hash) const;
+    uint32_t maxDepth() const { return depthBuckets.empty() ? 0 : static_cast<uint32_t>(depthBuckets.size() - 1); }
+
+    // An unconfirmed transaction more than maxTipAge levels below the deepest one
+    bool isLazyTip(const std::string& hash) const;
+
+    // One weighted walk from a random entry point entryDepth levels below the
+    // deepest transaction, but never below the checkpoint frontier, to a tip;
+    // empty if the walk ends on a lazy tip
+    std::string walkToTip(std::mt19937_64& walkRng) const;
+
+    // Freeze the walk window (entry depth and up) with its transition weights, so
+    // many walks can run in parallel without touching the DAG (see TipSelectionEngine)
+    WalkSnapshot buildWalkSnapshot() const;
+
+    // Parents per transaction in this configuration
+    static constexpr size_t parentCount() { return Policies::numParents; }
+
+    // Transactions that directly approve the given transaction
+    const std::vector<std::string>& getApprovers(const std::string& hash) const;
+
+    // True if 'approver' directly or indirectly approves 'approved'
+    bool approves(const std::string& approver, const std::string& approved) const;
+
+    // Number of transactions approved by / approving the given one, directly or indirectly.
+    // Exact, and O(cone size) per call (see ReachabilityIndex); currentWeight() gives the
+    // cheap estimate in Approximate mode.
+    size_t countPastCone(const std::string& hash) const;
+    size_t countFutureCone(const std::string& hash) const;
+
+    // Switch weight computation at runtime; entering Approximate mode builds the sketches.
+    // The estimate's relative standard error is about 1.04 / sqrt(2^sketchPrecision).
+    void setWeightMode(WeightMode mode, unsigned sketchPrecision = 7);
+    WeightMode getWeightMode() const { return weightMode; }
+
+    // Weight consensus would use right now: the sketch estimate in Approximate mode,
+    // otherwise the weight cached by the last consensus pass
+    double currentWeight(const std::string& hash) const;
+
+    // Copy out the transaction with the given dense id; false if unknown
+    bool getTransactionById(uint32_t id, TransactionNode& transaction) const;
+
+    // Copy out a transaction whether it is in memory or cold; false if unknown
+    bool getTransaction(const std::string& hash, TransactionNode& transaction) const;
+
+    // Visit every transaction: in-memory ones first, then cold ones in hash order
+    void forEachTransaction(const std::function<void(const TransactionNode&)>& visit) const;
+
+    // Move frozen transactions older than the newest hotWindow node ids out of memory into
+    // the store; lookups, queries, saves and validation fall through to it transparently.
+    // Limit: loading from a file or archive, and switching stores, bring the whole history
+    // back into memory, because the indexes are rebuilt in topological order from complete
+    // transactions. The cold part moves out again when the loaded checkpoint is restored,
+    // or at the next consensus pass, so memory peaks at the full history during a load.
+    void setColdStore(std::unique_ptr<TransactionStore> store, size_t hotWindow = 4096);
+    size_t coldTransactionCount() const { return coldStore ? coldStore->size() : 0; }
+
+    // Transactions with from <= timestamp <= to, oldest first, fetched page by page.
+    // Cursors borrow the DAG's index: attaching more transactions is safe, but a cursor
+    // must not be used after the DAG is destroyed or its indexes are rebuilt, which
+    // every load (loadTransactionsFromFile, loadTransactionsFromArchive) does.
+    TransactionCursor queryTimeRange(time_t from, time_t to) const;
+
+    // Most recent transactions sent or received by the account, newest first; the
+    // cursor has the same lifetime rule as queryTimeRange
+    TransactionCursor queryAccount(const std::string& account, size_t limit = SIZE_MAX) const;
+
+    // Approval labels behind approves() and the cone sizes, one per node id
+    const ReachabilityIndex& getReachabilityIndex() const { return reachability; }
+
+    // Columnar view of amounts and fees, one row per node id
+    const AmountColumns& getAmountColumns() const { return amountColumns; }
+
+    // Freeze the confirmed prefix of the DAG; returns the number of newly frozen transactions.
+    // Runs automatically at the end of every consensus pass.
+    size_t createCheckpoint();
+
+    bool isFrozen(const std::string& hash) const;
+
+    // Validated by consensus / retired by the checkpoint without being confirmed.
+    // Both read in-memory flags only, so they never touch the cold store.
+    bool isConfirmed(const std::string& hash) const;
+    bool isRetired(const std::string& hash) const;
+    size_t checkpointHeight() const { return frozenCount; }
+    const std::vector<std::string>& getCheckpointFrontier() const { return checkpointFrontier; }
+
     // Function to print the DAG details (transactions and adjacency list)
     void printDAG() const;
     double calculateFee(double amount);
-    // Function to save transactions to a file
+    // Function to save transactions to a file; the checkpoint (frontier and retired
+    // transactions) goes to filename + ".checkpoint" and is restored on load
     void saveTransactionsToFile(const std::string& filename);
 
     // Function to load transactions from a file
     bool loadTransactionsFromFile(const std::string& filename);
 
-    // Getter for transactions map
-    const unordered_map<string, TransactionNode>& getTransactions() const {
+    // Compressed block archive; blocks follow attach order and decode in parallel on load
+    bool saveTransactionsToArchive(const std::string& filename, size_t transactionsPerBlock = 4096);
+    bool loadTransactionsFromArchive(const std::string& filename);
+
+    // Tip count, width, depth, parent ages, confirmation times, orphans and approvers,
+    // all kept up to date incrementally; export with getStatistics().writeMetrics(out)
+    const DAGStatistics& getStatistics() const { return statistics; }
+
+    // Print bytes per structure, bytes per node, load factors and slack
+    void memoryReport(std::ostream& out = std::cout) const;
+
+    // Getter for the in-memory transactions map; cold transactions are not included
+    const TransactionMap& getTransactions() const {
         return transactions;
     }
 };
 
+#include "DAG.tpp"
+
+// Compiled once in DAG.cpp; this only saves every caller from instantiating it again
+extern template class BasicDAG<DefaultDAGPolicies>;
+
+using DAG = BasicDAG<DefaultDAGPolicies>;
+
 #endif // DAG_H
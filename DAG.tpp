@@ -0,0 +1,1266 @@
+// BasicDAG member definitions, included at the end of DAG.h so any policy
+// bundle can be instantiated by the code that uses it. DAG.cpp compiles the
+// default bundle once for the library; DAG.h declares it extern so callers
+// of DAG reuse that copy instead of instantiating their own.
+#include <iostream>
+#include <cmath>
+#include <ctime>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <unordered_set>
+#include <unordered_map>
+#include <fstream>
+#include <vector>
+#include <queue>
+#include <deque>
+#include <algorithm>
+#include "TransactionNode.h"
+#include "HashUtils.h"
+#include <stdexcept>
+
+// Function to save transactions to a file
+template <typename Policies>
+void BasicDAG<Policies>::saveTransactionsToFile(const std::string& filename) {
+    std::ofstream outFile(filename, std::ios::out | std::ios::trunc);
+    if (!outFile) {
+        std::cerr << "Error opening file '" << filename << "' for saving transactions.\n";
+        return;
+    }
+
+    forEachTransaction([&outFile](const TransactionNode& t) {
+        outFile << t.id << "," << t.senderAcc << "," << t.receiverAcc << ","
+            << t.amount << "," << t.fee << "," << t.timestamp << ","
+            << t.hash;
+
+        for (const auto& parent : t.parentHashes) {
+            outFile << "," << parent;
+        }
+        outFile << "\n";
+    });
+
+    outFile.close();
+    saveCheckpoint(filename + ".checkpoint");
+    std::cout << "Transactions saved to file: " << filename << "\n";
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::loadTransactionsFromFile(const std::string& filename) {
+    std::ifstream inFile(filename, std::ios::in);
+    if (!inFile) {
+        std::cerr << "Error opening file '" << filename << "' for loading transactions.\n";
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(inFile, line)) {
+        std::stringstream ss(line);
+        TransactionNode transaction;
+
+        if (!(std::getline(ss, transaction.id, ',') &&
+            std::getline(ss, transaction.senderAcc, ',') &&
+            std::getline(ss, transaction.receiverAcc, ',') &&
+            (ss >> transaction.amount) && ss.ignore(1, ',') &&
+            (ss >> transaction.fee) && ss.ignore(1, ',') &&
+            (ss >> transaction.timestamp) && ss.ignore(1, ',') &&
+            std::getline(ss, transaction.hash, ','))) {
+            std::cerr << "Error parsing transaction line: " << line << "\n";
+            continue;
+        }
+
+        std::string parentHash;
+        while (std::getline(ss, parentHash, ',')) {
+            transaction.parentHashes.push_back(parentHash);
+        }
+
+        transactions[transaction.hash] = transaction;
+    }
+
+    inFile.close();
+    rebuildIndexes();
+    loadCheckpoint(filename + ".checkpoint");
+    std::cout << "Transactions loaded from file: " << filename << "\n";
+    return true;
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::saveTransactionsToArchive(const std::string& filename, size_t transactionsPerBlock) {
+    ArchiveWriter writer;
+    if (!writer.open(filename)) {
+        return false;
+    }
+    transactionsPerBlock = std::max<size_t>(transactionsPerBlock, 1);
+
+    // Attach order is topological, which keeps most parent references inside the block
+    std::vector<const TransactionNode*> block;
+    std::deque<TransactionNode> coldCopies;  // Cold transactions of the current block
+    block.reserve(transactionsPerBlock);
+    auto flush = [&]() {
+        bool ok = writer.addBlock(block);
+        block.clear();
+        coldCopies.clear();
+        return ok;
+    };
+
+    bool ok = true;
+    for (const auto& hash : nodeHashes) {
+        auto hot = transactions.find(hash);
+        if (hot != transactions.end()) {
+            block.push_back(&hot->second);
+        }
+        else {
+            coldCopies.emplace_back();
+            if (!coldStore || !coldStore->get(hash, coldCopies.back())) {
+                std::cerr << "Transaction " << hash << " is missing from the cold store.\n";
+                coldCopies.pop_back();
+                ok = false;
+                continue;
+            }
+            block.push_back(&coldCopies.back());
+        }
+        if (block.size() == transactionsPerBlock) {
+            ok = flush() && ok;
+        }
+    }
+    // Transactions that could not be indexed go last
+    for (const auto& pair : transactions) {
+        if (nodeIds.find(pair.first) == nodeIds.end()) {
+            block.push_back(&pair.second);
+            if (block.size() == transactionsPerBlock) {
+                ok = flush() && ok;
+            }
+        }
+    }
+    ok = flush() && ok;
+    ok = writer.finish() && ok;
+
+    if (!ok) {
+        std::cerr << "Error writing archive '" << filename << "'.\n";
+        return false;
+    }
+    saveCheckpoint(filename + ".checkpoint");
+    std::cout << "Transactions archived to file: " << filename << " (" << writer.bytesWritten() << " bytes; blocks compressed "
+        << writer.rawBlockBytes() << " -> " << writer.compressedBlockBytes() << " bytes, "
+        << writer.compressionRatio() << ":1)\n";
+    return true;
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::loadTransactionsFromArchive(const std::string& filename) {
+    ArchiveReader reader;
+    std::vector<TransactionNode> loaded;
+    if (!reader.open(filename) || !reader.readAll(loaded)) {
+        return false;
+    }
+
+    for (auto& transaction : loaded) {
+        std::string hash = transaction.hash;
+        transactions[hash] = std::move(transaction);
+    }
+
+    rebuildIndexes();
+    loadCheckpoint(filename + ".checkpoint");
+    std::cout << "Transactions loaded from archive: " << filename << "\n";
+    return true;
+}
+
+// Checkpoint file: a header line with the frozen count, then one frontier hash per line,
+// then a "retired" line followed by one retired hash per line
+template <typename Policies>
+bool BasicDAG<Policies>::saveCheckpoint(const std::string& filename) const {
+    std::ofstream outFile(filename, std::ios::out | std::ios::trunc);
+    if (!outFile) {
+        std::cerr << "Error opening file '" << filename << "' for saving checkpoint.\n";
+        return false;
+    }
+
+    outFile << "checkpoint," << frozenCount << "\n";
+    for (const auto& hash : checkpointFrontier) {
+        outFile << hash << "\n";
+    }
+    outFile << "retired\n";
+    for (size_t id = 0; id < frozen.size(); ++id) {
+        if (frozen[id] == retiredMark) {
+            outFile << nodeHashes[id] << "\n";
+        }
+    }
+    return static_cast<bool>(outFile);
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::loadCheckpoint(const std::string& filename) {
+    std::ifstream inFile(filename, std::ios::in);
+    if (!inFile) {
+        return false;  // No checkpoint yet; everything stays live
+    }
+
+    std::string line;
+    if (!std::getline(inFile, line) || line.compare(0, 11, "checkpoint,") != 0) {
+        std::cerr << "Error parsing checkpoint header in '" << filename << "'.\n";
+        return false;
+    }
+
+    // Everything in the past cone of the frontier was confirmed when the checkpoint was taken
+    std::vector<uint32_t> pending;
+    std::vector<std::string> frontier;
+    std::vector<uint32_t> retired;
+    bool inRetired = false;
+    while (std::getline(inFile, line)) {
+        if (line == "retired") {
+            inRetired = true;
+            continue;
+        }
+        auto it = nodeIds.find(line);
+        if (it == nodeIds.end()) {
+            std::cerr << "Checkpoint references unknown transaction " << line << "\n";
+            continue;
+        }
+        if (inRetired) {
+            retired.push_back(it->second);
+            continue;
+        }
+        frontier.push_back(line);
+        pending.push_back(it->second);
+    }
+
+    while (!pending.empty()) {
+        uint32_t id = pending.back();
+        pending.pop_back();
+        if (frozen[id]) {
+            continue;
+        }
+        freezeNode(id);
+        for (const auto& parent : transactions[nodeHashes[id]].parentHashes) {
+            auto it = nodeIds.find(parent);
+            if (it != nodeIds.end() && !frozen[it->second]) {
+                pending.push_back(it->second);
+            }
+        }
+    }
+
+    // Retired transactions were never confirmed; they stay out of tip selection and consensus
+    for (uint32_t id : retired) {
+        if (!frozen[id]) {
+            frozen[id] = retiredMark;
+            statistics.recordOrphan(id);
+            removeTip(nodeHashes[id]);
+        }
+    }
+
+    checkpointFrontier = frontier;
+    updateFrontierFloor();
+    while (liveStart < frozen.size() && frozen[liveStart]) {
+        ++liveStart;
+    }
+    evictColdTransactions();
+    return true;
+}
+
+template <typename Policies>
+void BasicDAG<Policies>::freezeNode(uint32_t id) {
+    frozen[id] = frozenMark;
+    ++frozenCount;
+    transactions[nodeHashes[id]].isValidated = true;
+    sketches.settle(id);
+    statistics.recordConfirmation(id);
+}
+
+template <typename Policies>
+size_t BasicDAG<Policies>::createCheckpoint() {
+    // Node ids are topological, so a validated prefix is closed under approval.
+    // A lazy transaction whose approvers are all lazy can no longer be approved
+    // or confirmed, so it is retired rather than holding the checkpoint back forever.
+    std::vector<uint32_t> newlyFrozen;
+    while (liveStart < nodeHashes.size()) {
+        if (!frozen[liveStart]) {
+            const std::string& hash = nodeHashes[liveStart];
+            if (!transactions[hash].isValidated) {
+                if (!isLazyTip(hash) || hasLiveApprover(hash)) {
+                    break;
+                }
+                frozen[liveStart] = retiredMark;
+                statistics.recordOrphan(static_cast<uint32_t>(liveStart));
+                removeTip(hash);
+            }
+            else {
+                freezeNode(static_cast<uint32_t>(liveStart));
+                newlyFrozen.push_back(static_cast<uint32_t>(liveStart));
+            }
+        }
+        ++liveStart;
+    }
+    evictColdTransactions();
+
+    if (newlyFrozen.empty()) {
+        return 0;
+    }
+
+    // Only the old frontier and the newly frozen nodes can be on the new frontier
+    std::vector<std::string> frontier;
+    auto onFrontier = [this](const std::string& hash) {
+        for (const auto& approver : getApprovers(hash)) {
+            auto it = nodeIds.find(approver);
+            if (it != nodeIds.end() && frozen[it->second] == frozenMark) {
+                return false;
+            }
+        }
+        return true;
+    };
+    for (const auto& hash : checkpointFrontier) {
+        if (onFrontier(hash)) {
+            frontier.push_back(hash);
+        }
+    }
+    for (uint32_t id : newlyFrozen) {
+        if (onFrontier(nodeHashes[id])) {
+            frontier.push_back(nodeHashes[id]);
+        }
+    }
+    checkpointFrontier.swap(frontier);
+    updateFrontierFloor();
+
+    if (verbose) {
+        std::cout << "Checkpoint advanced by " << newlyFrozen.size() << " transactions ("
+            << frozenCount << " frozen, frontier of " << checkpointFrontier.size() << ").\n";
+    }
+    return newlyFrozen.size();
+}
+
+// True if some transaction in the future cone is not lazy and could still gain approvers
+template <typename Policies>
+bool BasicDAG<Policies>::hasLiveApprover(const std::string& hash) const {
+    std::unordered_set<std::string> visited;
+    std::vector<std::string> pending(getApprovers(hash));
+    while (!pending.empty()) {
+        std::string current = std::move(pending.back());
+        pending.pop_back();
+        if (!visited.insert(current).second) {
+            continue;
+        }
+        if (!isLazyTip(current)) {
+            return true;
+        }
+        const auto& approvers = getApprovers(current);
+        pending.insert(pending.end(), approvers.begin(), approvers.end());
+    }
+    return false;
+}
+
+template <typename Policies>
+void BasicDAG<Policies>::evictColdTransactions() {
+    if (!coldStore) {
+        return;
+    }
+    // Ids below liveStart are all frozen or retired, so their payloads are final
+    size_t limit = liveStart > hotWindow ? liveStart - hotWindow : 0;
+    for (; coldStart < limit; ++coldStart) {
+        const std::string& hash = nodeHashes[coldStart];
+        auto it = transactions.find(hash);
+        if (it != transactions.end()) {
+            coldStore->put(it->second);
+            transactions.erase(it);
+        }
+        cumulativeWeights.erase(hash);
+    }
+}
+
+// Bring every cold transaction back into memory, e.g. before the indexes are rebuilt.
+// This is the one place the whole history is materialised (see setColdStore in DAG.h).
+template <typename Policies>
+void BasicDAG<Policies>::restoreColdTransactions() {
+    if (coldStore && coldStore->size() > 0) {
+        coldStore->forEach([this](const TransactionNode& transaction) {
+            transactions.emplace(transaction.hash, transaction);
+        });
+        coldStore->clear();
+    }
+    coldStart = 0;
+}
+
+template <typename Policies>
+void BasicDAG<Policies>::setColdStore(std::unique_ptr<TransactionStore> store, size_t window) {
+    restoreColdTransactions();
+    coldStore = std::move(store);
+    hotWindow = window;
+    evictColdTransactions();
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::isFrozen(const std::string& hash) const {
+    auto it = nodeIds.find(hash);
+    return it != nodeIds.end() && frozen[it->second] == frozenMark;
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::isConfirmed(const std::string& hash) const {
+    auto it = nodeIds.find(hash);
+    if (it == nodeIds.end() || frozen[it->second] == retiredMark) {
+        return false;
+    }
+    if (frozen[it->second] == frozenMark) {
+        return true;
+    }
+    // Live nodes are never cold
+    auto transaction = transactions.find(hash);
+    return transaction != transactions.end() && transaction->second.isValidated;
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::isRetired(const std::string& hash) const {
+    auto it = nodeIds.find(hash);
+    return it != nodeIds.end() && frozen[it->second] == retiredMark;
+}
+
+template <typename Policies>
+void BasicDAG<Policies>::addTip(const std::string& hash) {
+    if (tipPositions.find(hash) != tipPositions.end()) {
+        return;
+    }
+    tipPositions[hash] = tipList.size();
+    tipList.push_back(hash);
+
+    auto id = nodeIds.find(hash);
+    if (id != nodeIds.end()) {
+        statistics.recordTipAdded(id->second);
+    }
+}
+
+template <typename Policies>
+void BasicDAG<Policies>::removeTip(const std::string& hash) {
+    auto it = tipPositions.find(hash);
+    if (it == tipPositions.end()) {
+        return;
+    }
+
+    // Swap the last tip into the freed slot so removal stays O(1)
+    size_t position = it->second;
+    tipPositions.erase(it);
+    if (position != tipList.size() - 1) {
+        tipList[position] = tipList.back();
+        tipPositions[tipList[position]] = position;
+    }
+    tipList.pop_back();
+
+    auto id = nodeIds.find(hash);
+    if (id != nodeIds.end()) {
+        statistics.recordTipRemoved(id->second);
+    }
+}
+
+// Recompute approver lists, tips and indexes after transactions were inserted directly
+template <typename Policies>
+void BasicDAG<Policies>::rebuildIndexes() {
+    // The next checkpoint moves the cold part out again
+    restoreColdTransactions();
+
+    adjList.clear();
+    cumulativeWeights.clear();
+    tipList.clear();
+    tipPositions.clear();
+    nodeHashes.clear();
+    nodeIds.clear();
+    reachability.clear();
+    secondaryIndex.clear();
+    amountColumns.clear();
+    frozen.clear();
+    liveStart = 0;
+    frozenCount = 0;
+    checkpointFrontier.clear();
+    frontierFloor = 0;
+    depths.clear();
+    depthBuckets.clear();
+    sketches.clear();
+    statistics.clear();
+
+    // Index in topological order (Kahn), since every parent needs an id before its children
+    std::unordered_map<std::string, size_t> pendingParents;
+    std::queue<std::string> ready;
+    for (const auto& pair : transactions) {
+        size_t known = 0;
+        for (const auto& parent : pair.second.parentHashes) {
+            if (transactions.find(parent) != transactions.end()) {
+                adjList[parent].push_back(pair.first);
+                ++known;
+            }
+        }
+        pendingParents[pair.first] = known;
+        if (known == 0) {
+            ready.push(pair.first);
+        }
+    }
+
+    while (!ready.empty()) {
+        std::string hash = ready.front();
+        ready.pop();
+        indexTransaction(transactions[hash]);
+
+        auto approvers = adjList.find(hash);
+        if (approvers == adjList.end() || approvers->second.empty()) {
+            addTip(hash);
+            continue;
+        }
+        for (const auto& approver : approvers->second) {
+            if (--pendingParents[approver] == 0) {
+                ready.push(approver);
+            }
+        }
+    }
+
+    if (nodeHashes.size() != transactions.size()) {
+        std::cerr << "Warning: " << transactions.size() - nodeHashes.size()
+            << " transactions are part of a cycle and were not indexed.\n";
+    }
+}
+
+// Assign the next dense id and extend the index structures; parents must already be indexed
+template <typename Policies>
+void BasicDAG<Policies>::indexTransaction(const TransactionNode& transaction) {
+    std::vector<uint32_t> parentIds;
+    parentIds.reserve(transaction.parentHashes.size());
+    uint32_t depth = 0;
+    for (const auto& parent : transaction.parentHashes) {
+        auto it = nodeIds.find(parent);
+        if (it != nodeIds.end()) {
+            parentIds.push_back(it->second);
+            depth = std::max(depth, depths[it->second] + 1);
+        }
+    }
+
+    uint32_t id = reachability.addNode(parentIds);
+    frozen.push_back(0);
+    if (weightMode == WeightMode::Approximate) {
+        sketches.addNode(parentIds);
+        if (transaction.isValidated) {
+            sketches.settle(id);
+        }
+    }
+    depths.push_back(depth);
+    if (depth >= depthBuckets.size()) {
+        depthBuckets.resize(depth + 1);
+    }
+    depthBuckets[depth].push_back(id);
+    statistics.recordAttach(depth, static_cast<int64_t>(transaction.timestamp), parentIds, transaction.isValidated);
+    nodeIds[transaction.hash] = id;
+    nodeHashes.push_back(transaction.hash);
+    secondaryIndex.add(id, transaction);
+    amountColumns.append(transaction);
+}
+
+template <typename Policies>
+uint32_t BasicDAG<Policies>::depthOf(const std::string& hash) const {
+    auto it = nodeIds.find(hash);
+    return it == nodeIds.end() ? 0 : depths[it->second];
+}
+
+template <typename Policies>
+void BasicDAG<Policies>::setWeightMode(WeightMode mode, unsigned sketchPrecision) {
+    weightMode = mode;
+    if (mode == WeightMode::Approximate) {
+        sketches.setPrecision(sketchPrecision);
+        rebuildSketches();
+    }
+    else {
+        sketches.clear();
+    }
+}
+
+// Replay every node in id order; confirmed nodes settle at once, since their weights no longer matter
+template <typename Policies>
+void BasicDAG<Policies>::rebuildSketches() {
+    sketches.clear();
+    std::vector<uint32_t> parentIds;
+    TransactionNode transaction;
+    for (size_t id = 0; id < nodeHashes.size(); ++id) {
+        parentIds.clear();
+        bool found = getTransaction(nodeHashes[id], transaction);
+        if (found) {
+            for (const auto& parent : transaction.parentHashes) {
+                auto it = nodeIds.find(parent);
+                if (it != nodeIds.end()) {
+                    parentIds.push_back(it->second);
+                }
+            }
+        }
+        sketches.addNode(parentIds);
+        if (!found || transaction.isValidated || frozen[id]) {
+            sketches.settle(static_cast<uint32_t>(id));
+        }
+    }
+}
+
+template <typename Policies>
+double BasicDAG<Policies>::currentWeight(const std::string& hash) const {
+    if (weightMode == WeightMode::Approximate) {
+        auto it = nodeIds.find(hash);
+        return it == nodeIds.end() ? 0.0 : sketches.estimate(it->second);
+    }
+    auto weight = cumulativeWeights.find(hash);
+    return weight == cumulativeWeights.end() ? WeightPolicy::baseWeight : weight->second;
+}
+
+template <typename Policies>
+void BasicDAG<Policies>::updateFrontierFloor() {
+    frontierFloor = 0;
+    bool first = true;
+    for (const auto& hash : checkpointFrontier) {
+        auto it = nodeIds.find(hash);
+        if (it == nodeIds.end()) {
+            continue;
+        }
+        frontierFloor = first ? depths[it->second] : std::min(frontierFloor, depths[it->second]);
+        first = false;
+    }
+}
+
+// Everything below the frontier is frozen history, so walks start at or above it
+template <typename Policies>
+uint32_t BasicDAG<Policies>::walkEntryLevel() const {
+    uint32_t top = maxDepth();
+    uint32_t level = top > walkConfig.entryDepth ? top - walkConfig.entryDepth : 0;
+    return std::min(std::max(level, frontierFloor), top);
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::isLazyTip(const std::string& hash) const {
+    auto it = nodeIds.find(hash);
+    if (it == nodeIds.end()) {
+        return false;
+    }
+    if (frozen[it->second] == retiredMark) {
+        return true;
+    }
+    if (depths[it->second] + walkConfig.maxTipAge >= maxDepth()) {
+        return false;
+    }
+    auto transaction = transactions.find(hash);
+    return transaction != transactions.end() && !transaction->second.isValidated;
+}
+
+template <typename Policies>
+std::string BasicDAG<Policies>::walkToTip(std::mt19937_64& walkRng) const {
+    if (depthBuckets.empty()) {
+        return {};
+    }
+
+    // Every depth up to the maximum is populated, since a node's deepest parent sits one level up
+    const std::vector<uint32_t>& entries = depthBuckets[walkEntryLevel()];
+    uint32_t current = entries[std::uniform_int_distribution<size_t>(0, entries.size() - 1)(walkRng)];
+
+    std::vector<double> transitions;
+    for (size_t step = 0; step < walkConfig.maxSteps; ++step) {
+        const std::string& hash = nodeHashes[current];
+        auto approvers = adjList.find(hash);
+        if (approvers == adjList.end() || approvers->second.empty()) {
+            return isLazyTip(hash) ? std::string() : hash;
+        }
+
+        const std::vector<std::string>& next = approvers->second;
+        size_t choice = 0;
+        if (walkConfig.alpha <= 0.0 || next.size() == 1) {
+            choice = std::uniform_int_distribution<size_t>(0, next.size() - 1)(walkRng);
+        }
+        else {
+            // P(approver) ~ exp(alpha * (weight - heaviest))
+            transitions.clear();
+            double heaviest = 0.0;
+            for (const auto& approver : next) {
+                transitions.push_back(currentWeight(approver));
+                heaviest = std::max(heaviest, transitions.back());
+            }
+            for (auto& transition : transitions) {
+                transition = std::exp(walkConfig.alpha * (transition - heaviest));
+            }
+            choice = std::discrete_distribution<size_t>(transitions.begin(), transitions.end())(walkRng);
+        }
+
+        auto nextId = nodeIds.find(next[choice]);
+        if (nextId == nodeIds.end()) {
+            return {};
+        }
+        current = nextId->second;
+    }
+    return {};
+}
+
+template <typename Policies>
+WalkSnapshot BasicDAG<Policies>::buildWalkSnapshot() const {
+    WalkSnapshot snapshot;
+    snapshot.maxSteps = walkConfig.maxSteps;
+    if (depthBuckets.empty()) {
+        return snapshot;
+    }
+
+    // Approvers are always deeper than what they approve, so the window is closed under approval
+    uint32_t top = maxDepth();
+    uint32_t entryLevel = walkEntryLevel();
+    std::unordered_map<uint32_t, uint32_t> localIds;
+    for (uint32_t depth = entryLevel; depth <= top; ++depth) {
+        for (uint32_t id : depthBuckets[depth]) {
+            localIds[id] = static_cast<uint32_t>(snapshot.hashes.size());
+            snapshot.hashes.push_back(nodeHashes[id]);
+        }
+    }
+    snapshot.entries.resize(depthBuckets[entryLevel].size());
+    for (uint32_t i = 0; i < snapshot.entries.size(); ++i) {
+        snapshot.entries[i] = i;
+    }
+
+    std::vector<double> weights;
+    snapshot.approverOffsets.reserve(snapshot.hashes.size() + 1);
+    snapshot.approverOffsets.push_back(0);
+    snapshot.selectable.reserve(snapshot.hashes.size());
+    for (const auto& hash : snapshot.hashes) {
+        const std::vector<std::string>& next = getApprovers(hash);
+
+        // Same transition rule as walkToTip: P(approver) ~ exp(alpha * (weight - heaviest))
+        weights.clear();
+        double heaviest = 0.0;
+        for (const auto& approver : next) {
+            weights.push_back(walkConfig.alpha > 0.0 ? currentWeight(approver) : 0.0);
+            heaviest = std::max(heaviest, weights.back());
+        }
+        double total = 0.0;
+        for (size_t i = 0; i < next.size(); ++i) {
+            // Approvers that are not attached (or not in the window) are not walkable
+            auto node = nodeIds.find(next[i]);
+            if (node == nodeIds.end()) {
+                continue;
+            }
+            auto local = localIds.find(node->second);
+            if (local == localIds.end()) {
+                continue;
+            }
+            total += walkConfig.alpha > 0.0 ? std::exp(walkConfig.alpha * (weights[i] - heaviest)) : 1.0;
+            snapshot.approvers.push_back(local->second);
+            snapshot.transitions.push_back(total);
+        }
+        snapshot.approverOffsets.push_back(static_cast<uint32_t>(snapshot.approvers.size()));
+        snapshot.selectable.push_back(next.empty() && !isLazyTip(hash));
+    }
+    return snapshot;
+}
+
+template <typename Policies>
+const std::vector<std::string>& BasicDAG<Policies>::getApprovers(const std::string& hash) const {
+    static const std::vector<std::string> none;
+    auto it = adjList.find(hash);
+    return it == adjList.end() ? none : it->second;
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::approves(const std::string& approver, const std::string& approved) const {
+    auto from = nodeIds.find(approver);
+    auto to = nodeIds.find(approved);
+    if (from == nodeIds.end() || to == nodeIds.end() || from->second == to->second) {
+        return false;
+    }
+    return reachability.reaches(from->second, to->second);
+}
+
+template <typename Policies>
+size_t BasicDAG<Policies>::countPastCone(const std::string& hash) const {
+    auto it = nodeIds.find(hash);
+    return it == nodeIds.end() ? 0 : reachability.countPastCone(it->second);
+}
+
+template <typename Policies>
+size_t BasicDAG<Policies>::countFutureCone(const std::string& hash) const {
+    auto it = nodeIds.find(hash);
+    return it == nodeIds.end() ? 0 : reachability.countFutureCone(it->second);
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::getTransactionById(uint32_t id, TransactionNode& transaction) const {
+    if (id >= nodeHashes.size()) {
+        return false;
+    }
+    return getTransaction(nodeHashes[id], transaction);
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::getTransaction(const std::string& hash, TransactionNode& transaction) const {
+    auto it = transactions.find(hash);
+    if (it != transactions.end()) {
+        transaction = it->second;
+        return true;
+    }
+    return coldStore && coldStore->get(hash, transaction);
+}
+
+template <typename Policies>
+void BasicDAG<Policies>::forEachTransaction(const std::function<void(const TransactionNode&)>& visit) const {
+    for (const auto& pair : transactions) {
+        visit(pair.second);
+    }
+    if (coldStore) {
+        coldStore->forEach(visit);
+    }
+}
+
+template <typename Policies>
+TransactionCursor BasicDAG<Policies>::queryTimeRange(time_t from, time_t to) const {
+    return secondaryIndex.timeRange(from, to, [this](uint32_t id, TransactionNode& transaction) {
+        return getTransactionById(id, transaction);
+    });
+}
+
+template <typename Policies>
+TransactionCursor BasicDAG<Policies>::queryAccount(const std::string& account, size_t limit) const {
+    return secondaryIndex.account(account, limit, [this](uint32_t id, TransactionNode& transaction) {
+        return getTransactionById(id, transaction);
+    });
+}
+
+template <typename Policies>
+int BasicDAG<Policies>::updateCumulativeWeights(const std::string& hash) {
+    auto cached = cumulativeWeights.find(hash);
+    if (cached != cumulativeWeights.end()) {
+        return cached->second;
+    }
+
+    int weight = WeightPolicy::baseWeight; // Base weight
+    cumulativeWeights[hash] = weight;
+    for (const auto& parent : getApprovers(hash)) {
+        weight = WeightPolicy::accumulate(weight, updateCumulativeWeights(parent)); // Accumulate parent's weight
+    }
+
+    cumulativeWeights[hash] = weight;
+    return weight;
+}
+
+
+// Select parents for a transaction using MCMC method
+//std::vector<std::string> DAG::selectParentsMCMC(size_t numParents) {
+//    std::vector<TipInfo> tips;
+//
+//    // Collect tips (transactions at the end of the graph)
+//    for (const auto& pair : transactions) {
+//        if (adjList[pair.first].empty()) {
+//            tips.push_back(TipInfo{
+//                pair.first,
+//                cumulativeWeights[pair.first],
+//                pair.second.timestamp,
+//                static_cast<int>(pair.second.amount),
+//                static_cast<int>(pair.second.fee)
+//                });
+//        }
+//    }
+//
+//    std::cout << "Tips found: " << tips.size() << std::endl;
+//
+//    if (tips.empty()) {
+//        std::cout << "No tips available for parent selection.\n";
+//        return {};
+//    }
+//
+//    // Ensure there are enough tips to select from
+//    if (tips.size() < numParents) {
+//        std::cerr << "Warning: Not enough tips available. Requested " << numParents
+//            << " but only " << tips.size() << " available.\n";
+//        numParents = tips.size();  // Adjust to select as many as available
+//    }
+//
+//    // Calculate probabilities based on multiple factors (weight, fee, amount)
+//    std::vector<double> probabilities;
+//    double totalWeight = 0.0;
+//
+//    for (const auto& tip : tips) {
+//        double timeDecay = exp(-static_cast<double>(difftime(time(nullptr), tip.timestamp)) / 3600.0);
+//        double feeFactor = 1 + log(1 + tip.fee);
+//        double amountFactor = log(1 + tip.amount);
+//
+//        // Combine factors to get weighted probability
+//        double weightedProbability = tip.cumulativeWeight * timeDecay * feeFactor * amountFactor;
+//
+//        probabilities.push_back(weightedProbability);
+//        totalWeight += weightedProbability;
+//    }
+//
+//    if (totalWeight == 0.0) {
+//        probabilities.assign(probabilities.size(), 1.0);
+//        totalWeight = probabilities.size();
+//    }
+//
+//    // Normalize probabilities
+//    for (auto& prob : probabilities) {
+//        prob /= totalWeight;
+//    }
+//
+//    // Select multiple parents using MCMC with calculated probabilities
+//    std::vector<std::string> selectedParents;
+//    std::default_random_engine generator(std::random_device{}());
+//    std::discrete_distribution<size_t> distribution(probabilities.begin(), probabilities.end());
+//
+//    std::unordered_set<std::string> selectedSet;
+//
+//    // Select unique parents to ensure diversity
+//    while (selectedParents.size() < numParents) {
+//        size_t index = distribution(generator);
+//        if (selectedSet.insert(tips[index].hash).second) {
+//            selectedParents.push_back(tips[index].hash);
+//        }
+//
+//        if (selectedParents.size() == numParents) {
+//            break;
+//        }
+//    }
+//
+//    if (selectedParents.size() < numParents) {
+//        std::cerr << "Warning: Could not select enough unique parents. "
+//            << "Selected " << selectedParents.size() << " out of " << numParents << ".\n";
+//    }
+//
+//    return selectedParents;
+//}
+
+
+template <typename Policies>
+std::vector<std::string> BasicDAG<Policies>::selectParentsMCMC(size_t numParents) {
+    const std::vector<std::string>& tips = tipList;
+
+    if (verbose) {
+        std::cout << "Tips found: " << tips.size() << std::endl;
+    }
+
+    if (tips.empty()) {
+        if (verbose) {
+            std::cout << "No tips available for parent selection.\n";
+        }
+        return {};
+    }
+
+    if (tips.size() < numParents) {
+        if (verbose) {
+            std::cout << "Warning: Not enough tips available. Requested " << numParents
+                << " but only " << tips.size() << " available.\n";
+        }
+        numParents = tips.size();  
+    }
+
+    std::vector<std::string> selectedParents = TipSelector::select(*this, numParents, rng);
+
+    if (selectedParents.size() < numParents) {
+        std::cerr << "Warning: Could not select enough unique parents. "
+            << "Selected " << selectedParents.size() << " out of " << numParents << ".\n";
+    }
+
+    return selectedParents;
+}
+
+template <typename Policies>
+double BasicDAG<Policies>::calculateFee(double amount) {
+    return FeePolicy::calculate(amount);
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::addTransaction(TransactionNode& transaction) {
+    double fee = calculateFee(transaction.amount); 
+    transaction.fee = fee;  
+    if (verbose) {
+        std::cout << "Calculated Fee: " << fee << std::endl;
+    }
+
+    std::vector<std::string> parentHashes = selectParentsMCMC(Policies::numParents);
+
+    transaction.parentHashes = parentHashes;
+    return attachTransaction(transaction);
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::attachTransaction(TransactionNode& transaction) {
+    if (nodeIds.find(transaction.hash) != nodeIds.end()) {
+        if (verbose) {
+            std::cout << "Transaction " << transaction.hash << " is already attached.\n";
+        }
+        return false;
+    }
+
+    // Everything is checked before any state changes. Parents must already be
+    // attached: dense ids then follow a topological order, which the reachability
+    // window and the depth buckets rely on, and no cycle can form because the new
+    // transaction has no approvers yet.
+    for (const auto& parent : transaction.parentHashes) {
+        if (parent == transaction.hash || nodeIds.find(parent) == nodeIds.end()) {
+            if (verbose) {
+                std::cout << "Transaction " << transaction.id << " approves unknown transaction " << parent << ".\n";
+            }
+            return false;
+        }
+        if (isLazyTip(parent)) {
+            if (verbose) {
+                std::cout << "Transaction " << transaction.id << " approves " << parent
+                    << ", which is more than " << walkConfig.maxTipAge << " levels below the tips.\n";
+            }
+            return false;
+        }
+    }
+
+    transactions[transaction.hash] = transaction;
+    indexTransaction(transaction);
+
+    // Record the new approval edges and retire the approved tips
+    for (const auto& parent : transaction.parentHashes) {
+        adjList[parent].push_back(transaction.hash);
+        removeTip(parent);
+    }
+    addTip(transaction.hash);
+    return true;
+}
+
+template <typename Policies>
+void BasicDAG<Policies>::performConsensus(double validationThreshold) {
+    std::unordered_set<std::string> visited;
+
+    // Approvers may have arrived since the last pass, so cached weights of live
+    // transactions are stale; weights below the checkpoint stay frozen.
+    // Sketches are maintained on attach and need no refresh.
+    if (weightMode == WeightMode::Exact) {
+        for (size_t id = liveStart; id < nodeHashes.size(); ++id) {
+            if (!frozen[id]) {
+                cumulativeWeights.erase(nodeHashes[id]);
+            }
+        }
+    }
+
+    for (size_t id = liveStart; id < nodeHashes.size(); ++id) {
+        const auto& hash = nodeHashes[id];
+        if (!frozen[id] && visited.find(hash) == visited.end()) {
+            validateTransaction(hash, validationThreshold, visited);
+        }
+    }
+
+    createCheckpoint();
+}
+
+template <typename Policies>
+bool BasicDAG<Policies>::validateTransaction(const std::string& hash, double validationThreshold, std::unordered_set<std::string>& visited) {
+    // Checkpointed transactions are terminal and may have moved to the cold store:
+    // frozen ones are validated, retired ones never will be. Lookups below use
+    // find() so an unknown or evicted hash never gains a blank entry.
+    auto node = nodeIds.find(hash);
+    if (node == nodeIds.end() || frozen[node->second] == retiredMark) {
+        return false;
+    }
+    if (frozen[node->second] == frozenMark) {
+        return true;
+    }
+    auto transaction = transactions.find(hash);
+    if (transaction == transactions.end()) {
+        return false;
+    }
+    if (!visited.insert(hash).second) {
+        return transaction->second.isValidated;
+    }
+
+    double cumulativeWeight = weightMode == WeightMode::Approximate
+        ? currentWeight(hash) : updateCumulativeWeights(hash);
+    if (verbose) {
+        std::cout << "Validating transaction " << hash << " with cumulative weight: " << cumulativeWeight << " against threshold " << validationThreshold << std::endl;
+    }
+
+    if (cumulativeWeight >= validationThreshold) {
+        transaction->second.isValidated = true;
+        uint32_t id = node->second;
+        if (weightMode == WeightMode::Approximate) {
+            sketches.settle(id);
+        }
+        statistics.recordConfirmation(id);
+        if (verbose) {
+            std::cout << "Transaction " << hash << " validated!" << std::endl;
+        }
+        return true;
+    }
+
+    for (const auto& parent : transaction->second.parentHashes) {
+        if (!validateTransaction(parent, validationThreshold, visited)) {
+            if (verbose) {
+                std::cout << "Parent " << parent << " validation failed!" << std::endl;
+            }
+            return false;
+        }
+    }
+
+    return transaction->second.isValidated;
+}
+
+
+
+//bool DAG::validateTransaction(const std::string& hash, double validationThreshold, std::unordered_set<std::string>& visited) {
+//    if (visited.find(hash) != visited.end()) {
+//        return transactions[hash].isValidated; // Already validated
+//    }
+//
+//    visited.insert(hash);
+//
+//    // Recalculate cumulative weight
+//    int cumulativeWeight = updateCumulativeWeights(hash);
+//    std::cout << "Validating transaction " << hash << " with cumulative weight: " << cumulativeWeight << " against threshold " << validationThreshold << std::endl;
+//
+//    // Mark as validated if the cumulative weight meets the threshold
+//    if (cumulativeWeight >= validationThreshold) {
+//        transactions[hash].isValidated = true;
+//        std::cout << "Transaction " << hash << " validated!" << std::endl;
+//        return true;
+//    }
+//
+//    // Validate parents recursively
+//    for (const auto& parent : transactions[hash].parentHashes) {
+//        if (!validateTransaction(parent, validationThreshold, visited)) {
+//            std::cout << "Parent " << parent << " validation failed!" << std::endl;
+//            return false; // If any parent is invalid, this transaction is invalid
+//        }
+//    }
+//
+//    return transactions[hash].isValidated;
+//}
+
+template <typename Policies>
+void BasicDAG<Policies>::printDAG() const {
+    std::cout << "All transactions:\n";
+    forEachTransaction([](const TransactionNode& t) {
+        std::cout << "ID: " << t.id << ", Sender: " << t.senderAcc
+            << ", Receiver: " << t.receiverAcc << ", Amount: "
+            << t.amount << ", Fee: " << t.fee << ", Timestamp: " << t.timestamp
+            << ", Hash: " << t.hash << ", Parents: ";
+        for (const auto& parentHash : t.parentHashes) {
+            std::cout << parentHash << " ";
+        }
+        std::cout << ", Validated: " << (t.isValidated ? "Yes" : "No") << "\n";
+    });
+
+    // Dynamically create the adjacency list
+    std::unordered_map<std::string, std::vector<std::string>> dynamicAdjList;
+
+    forEachTransaction([&dynamicAdjList](const TransactionNode& t) {
+        for (const auto& parentHash : t.parentHashes) {
+            dynamicAdjList[parentHash].push_back(t.hash); // Add this transaction as a child of the parent
+        }
+    });
+
+    std::cout << "\nGraph Adjacency List:\n";
+    for (const auto& pair : dynamicAdjList) {
+        std::cout << pair.first << " -> ";
+        for (const auto& neighbor : pair.second) {
+            std::cout << neighbor << ", ";
+        }
+        std::cout << std::endl;
+    }
+}
+
+template <typename Policies>
+void BasicDAG<Policies>::memoryReport(std::ostream& out) const {
+    // Heap bytes behind a string, or zero when it fits the small-string buffer
+    const size_t inlineCapacity = std::string().capacity();
+    size_t payloadBytes = 0;
+    size_t slackBytes = 0;
+    auto countString = [&](const std::string& value) {
+        if (value.capacity() > inlineCapacity) {
+            payloadBytes += value.capacity() + 1;
+            slackBytes += value.capacity() - value.size();
+        }
+    };
+    auto countStrings = [&](const std::vector<std::string>& values) {
+        payloadBytes += values.capacity() * sizeof(std::string);
+        slackBytes += (values.capacity() - values.size()) * sizeof(std::string);
+        for (const auto& value : values) {
+            countString(value);
+        }
+    };
+
+    for (const auto& pair : transactions) {
+        const auto& t = pair.second;
+        countString(pair.first);
+        countString(t.id);
+        countString(t.senderAcc);
+        countString(t.receiverAcc);
+        countString(t.hash);
+        countStrings(t.parentHashes);
+    }
+    size_t nodePayloadBytes = payloadBytes;
+    size_t nodeSlackBytes = slackBytes;
+
+    payloadBytes = 0;
+    slackBytes = 0;
+    for (const auto& pair : adjList) {
+        countString(pair.first);
+        countStrings(pair.second);
+    }
+    size_t approverPayloadBytes = payloadBytes;
+    size_t approverSlackBytes = slackBytes;
+
+    payloadBytes = 0;
+    slackBytes = 0;
+    countStrings(tipList);
+    countStrings(nodeHashes);
+    for (const auto& pair : nodeIds) {
+        countString(pair.first);
+    }
+    size_t indexStringBytes = payloadBytes;
+
+    size_t reachabilityBytes = reachability.memoryUsage();
+    size_t secondaryBytes = secondaryIndex.memoryUsage();
+    size_t columnBytes = amountColumns.memoryUsage();
+    size_t depthBytes = depths.capacity() * sizeof(uint32_t) + depthBuckets.capacity() * sizeof(depthBuckets[0]);
+    for (const auto& bucket : depthBuckets) {
+        depthBytes += bucket.capacity() * sizeof(uint32_t);
+    }
+    size_t coldBytes = coldStore ? coldStore->memoryUsage() : 0;
+    size_t sketchBytes = sketches.memoryUsage();
+    size_t statisticsBytes = statistics.memoryUsage();
+    size_t checkpointBytes = frozen.capacity();
+    for (const auto& hash : checkpointFrontier) {
+        checkpointBytes += sizeof(hash) + (hash.capacity() > inlineCapacity ? hash.capacity() + 1 : 0);
+    }
+
+    int64_t trackedBytes = 0;
+    out << "Memory report (" << transactions.size() << " transactions in memory, "
+        << coldTransactionCount() << " cold)\n";
+    out << "  Tracked container allocations:\n";
+    for (size_t s = 0; s < static_cast<size_t>(MemorySubsystem::Count); ++s) {
+        MemorySubsystem subsystem = static_cast<MemorySubsystem>(s);
+        trackedBytes += memoryCounters.bytes(subsystem);
+        out << "    " << memorySubsystemName(subsystem) << ": " << memoryCounters.bytes(subsystem)
+            << " bytes in " << memoryCounters.liveAllocations(subsystem) << " allocations\n";
+    }
+
+    out << "  Node payload (strings, parent vectors): " << nodePayloadBytes << " bytes\n";
+    out << "  Approver lists payload: " << approverPayloadBytes << " bytes\n";
+    out << "  Tip list and id map: " << indexStringBytes << " bytes (+ "
+        << (tipPositions.size() + nodeIds.size()) * (sizeof(void*) + sizeof(size_t)) << " bytes of map nodes, estimated)\n";
+    out << "  Reachability index: " << reachabilityBytes << " bytes\n";
+    out << "  Secondary indexes: " << secondaryBytes << " bytes\n";
+    out << "  Amount columns: " << columnBytes << " bytes\n";
+    out << "  Checkpoint state: " << checkpointBytes << " bytes\n";
+    if (coldStore) {
+        out << "  Cold store: " << coldBytes << " bytes in memory, " << coldStore->diskUsage() << " bytes on disk\n";
+    }
+    if (weightMode == WeightMode::Approximate) {
+        out << "  Weight sketches: " << sketchBytes << " bytes (" << (size_t(1) << sketches.getPrecision())
+            << " registers per node, ~" << 100.0 * sketches.standardError() << "% error)\n";
+    }
+    out << "  Depth index: " << depthBytes << " bytes (max depth " << maxDepth() << ")\n";
+    out << "  Statistics: " << statisticsBytes << " bytes\n";
+
+    size_t total = static_cast<size_t>(std::max<int64_t>(trackedBytes, 0)) + nodePayloadBytes + approverPayloadBytes
+        + indexStringBytes + reachabilityBytes + secondaryBytes + columnBytes + checkpointBytes + depthBytes + coldBytes + sketchBytes + statisticsBytes;
+    out << "  Total: " << total << " bytes";
+    if (!transactions.empty()) {
+        out << " (" << total / transactions.size() << " bytes per in-memory transaction)";
+    }
+    out << "\n";
+
+    out << "  Load factors: transactions=" << transactions.load_factor()
+        << " adjList=" << adjList.load_factor()
+        << " cumulativeWeights=" << cumulativeWeights.load_factor()
+        << " nodeIds=" << nodeIds.load_factor()
+        << " tipPositions=" << tipPositions.load_factor() << "\n";
+
+    // Capacity reserved but unused by vectors and heap strings
+    size_t slack = nodeSlackBytes + approverSlackBytes;
+    size_t used = nodePayloadBytes + approverPayloadBytes;
+    out << "  Internal fragmentation: " << slack << " slack bytes";
+    if (used > 0) {
+        out << " (" << 100.0 * static_cast<double>(slack) / static_cast<double>(used) << "% of payload)";
+    }
+    out << "\n";
+}
@@ -0,0 +1,82 @@
+#ifndef DAG_POLICIES_H
+#define DAG_POLICIES_H
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Compile-time policies for BasicDAG. Each policy is a stateless type with
+// static members, so every call is resolved and inlined per configuration
+// instead of going through a virtual interface on the hot path.
+//
+// A policy bundle provides:
+//   TipSelector::select(dag, count, rng) -> chosen parent hashes
+//   WeightPolicy::baseWeight, WeightPolicy::accumulate(weight, approverWeight)
+//   FeePolicy::calculate(amount) -> fee
+//   numParents, the parent count used by addTransaction
+
+// Weighted random walks from entry points a bounded depth below the deepest tip
+// (see BasicDAG::walkToTip), so walk cost does not grow with the DAG. If the
+// walks keep ending on the same tips, the rest are filled from the tip list,
+// skipping lazy tips since attachTransaction would reject them as parents.
+struct DepthBoundedWalkTipSelector {
+    template <typename DAGType, typename Rng>
+    static std::vector<std::string> select(const DAGType& dag, size_t count, Rng& rng) {
+        std::unordered_set<std::string> selectedSet;
+        std::vector<std::string> selected;
+        selected.reserve(count);
+
+        for (size_t attempt = 0; attempt < count * 8 && selected.size() < count; ++attempt) {
+            std::string tip = dag.walkToTip(rng);
+            if (!tip.empty() && selectedSet.insert(tip).second) {
+                selected.push_back(tip);
+            }
+        }
+
+        const std::vector<std::string>& tips = dag.getTips();
+        if (selected.size() < count && !tips.empty()) {
+            size_t offset = std::uniform_int_distribution<size_t>(0, tips.size() - 1)(rng);
+            size_t scanLimit = std::min(tips.size(), count * 64);
+            for (size_t i = 0; i < scanLimit && selected.size() < count; ++i) {
+                const std::string& tip = tips[(offset + i) % tips.size()];
+                if (!dag.isLazyTip(tip) && selectedSet.insert(tip).second) {
+                    selected.push_back(tip);
+                }
+            }
+        }
+        return selected;
+    }
+};
+
+// A transaction weighs one plus the weights of its approvers, saturating at INT_MAX
+struct ApproverSumWeight {
+    static constexpr int baseWeight = 1;
+
+    static int accumulate(int weight, int approverWeight) {
+        return (approverWeight > INT_MAX - weight) ? INT_MAX : weight + approverWeight;
+    }
+};
+
+// 1% below 1000, flat 50 above
+struct TieredFeePolicy {
+    static double calculate(double amount) {
+        if (amount < 1000) {
+            return amount * 0.01;
+        }
+        return 50.0;
+    }
+};
+
+// The configuration the node runs with
+struct DefaultDAGPolicies {
+    using TipSelector = DepthBoundedWalkTipSelector;
+    using WeightPolicy = ApproverSumWeight;
+    using FeePolicy = TieredFeePolicy;
+    static constexpr size_t numParents = 3;
+};
+
+#endif // DAG_POLICIES_H
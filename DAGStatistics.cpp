@@ -0,0 +1,205 @@
+#include "DAGStatistics.h"
+#include <algorithm>
+
+const uint8_t DAGStatistics::tipFlag;
+const uint8_t DAGStatistics::confirmedFlag;
+
+StatHistogram::StatHistogram(std::vector<double> bounds)
+    : upperBounds(std::move(bounds)), buckets(upperBounds.size() + 1, 0) {}
+
+size_t StatHistogram::bucketOf(double value) const {
+    return static_cast<size_t>(std::lower_bound(upperBounds.begin(), upperBounds.end(), value) - upperBounds.begin());
+}
+
+void StatHistogram::observe(double value) {
+    ++buckets[bucketOf(value)];
+    ++total;
+    valueSum += value;
+}
+
+void StatHistogram::forget(double value) {
+    size_t bucket = bucketOf(value);
+    if (buckets[bucket] == 0) {
+        return;
+    }
+    --buckets[bucket];
+    --total;
+    valueSum -= value;
+}
+
+void StatHistogram::clear() {
+    std::fill(buckets.begin(), buckets.end(), 0);
+    total = 0;
+    valueSum = 0.0;
+}
+
+void StatHistogram::writeMetrics(std::ostream& out, const std::string& name, const std::string& help) const {
+    out << "# HELP " << name << ' ' << help << '\n';
+    out << "# TYPE " << name << " histogram\n";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < upperBounds.size(); ++i) {
+        cumulative += buckets[i];
+        out << name << "_bucket{le=\"" << upperBounds[i] << "\"} " << cumulative << '\n';
+    }
+    out << name << "_bucket{le=\"+Inf\"} " << total << '\n';
+    out << name << "_sum " << valueSum << '\n';
+    out << name << "_count " << total << '\n';
+}
+
+DAGStatistics::DAGStatistics()
+    : parentAgeHistogram({ 0, 1, 2, 5, 10, 30, 60, 120, 300, 600, 1800 }),
+      confirmationHistogram({ 1, 2, 5, 10, 20, 30, 60, 120, 300, 600, 1800, 3600 }),
+      approverHistogram({ 0, 1, 2, 3, 4, 5, 6, 8, 10, 15, 20, 50 }) {}
+
+uint32_t DAGStatistics::recordAttach(uint32_t depth, int64_t timestamp, const std::vector<uint32_t>& parentIds, bool isConfirmed) {
+    uint32_t id = static_cast<uint32_t>(depths.size());
+    uint32_t oldCutoff = lazyCutoff();
+
+    timestamps.push_back(timestamp);
+    depths.push_back(depth);
+    approverCounts.push_back(0);
+    flags.push_back(isConfirmed ? confirmedFlag : 0);
+    clock = std::max(clock, timestamp);
+
+    if (depth >= levelWidths.size()) {
+        levelWidths.resize(depth + 1, 0);
+        openTipsAtDepth.resize(depth + 1, 0);
+    }
+    widest = std::max(widest, ++levelWidths[depth]);
+
+    // A deeper DAG moves the lazy cutoff up past tips that were fresh until now
+    for (uint32_t level = oldCutoff; level < lazyCutoff(); ++level) {
+        lazyTips += openTipsAtDepth[level];
+    }
+
+    approverHistogram.observe(0);
+    for (uint32_t parent : parentIds) {
+        if (parent >= id) {
+            continue;
+        }
+        approverHistogram.forget(approverCounts[parent]);
+        approverHistogram.observe(++approverCounts[parent]);
+        parentAgeHistogram.observe(static_cast<double>(std::max<int64_t>(timestamp - timestamps[parent], 0)));
+    }
+
+    if (isConfirmed) {
+        ++confirmed;
+    }
+    return id;
+}
+
+uint32_t DAGStatistics::lazyCutoff() const {
+    uint32_t deepest = depth();
+    return deepest > maxTipAge ? deepest - maxTipAge : 0;
+}
+
+void DAGStatistics::openTipAdded(uint32_t id) {
+    ++openTipsAtDepth[depths[id]];
+    if (depths[id] < lazyCutoff()) {
+        ++lazyTips;
+    }
+}
+
+void DAGStatistics::openTipRemoved(uint32_t id) {
+    --openTipsAtDepth[depths[id]];
+    if (depths[id] < lazyCutoff()) {
+        --lazyTips;
+    }
+}
+
+void DAGStatistics::recordTipAdded(uint32_t id) {
+    if (id >= flags.size() || (flags[id] & tipFlag)) {
+        return;
+    }
+    flags[id] |= tipFlag;
+    ++tips;
+    if (isOpenTip(id)) {
+        openTipAdded(id);
+    }
+}
+
+void DAGStatistics::recordTipRemoved(uint32_t id) {
+    if (id >= flags.size() || !(flags[id] & tipFlag)) {
+        return;
+    }
+    if (isOpenTip(id)) {
+        openTipRemoved(id);
+    }
+    flags[id] &= static_cast<uint8_t>(~tipFlag);
+    --tips;
+}
+
+void DAGStatistics::recordConfirmation(uint32_t id) {
+    if (id >= flags.size() || (flags[id] & confirmedFlag)) {
+        return;
+    }
+    if (isOpenTip(id)) {
+        openTipRemoved(id);
+    }
+    flags[id] |= confirmedFlag;
+    ++confirmed;
+    confirmationHistogram.observe(static_cast<double>(std::max<int64_t>(clock - timestamps[id], 0)));
+}
+
+void DAGStatistics::recordOrphan(uint32_t id) {
+    if (id < flags.size()) {
+        ++orphans;
+    }
+}
+
+void DAGStatistics::setMaxTipAge(uint32_t age) {
+    maxTipAge = age;
+    lazyTips = 0;
+    for (uint32_t level = 0; level < lazyCutoff(); ++level) {
+        lazyTips += openTipsAtDepth[level];
+    }
+}
+
+void DAGStatistics::clear() {
+    timestamps.clear();
+    depths.clear();
+    approverCounts.clear();
+    flags.clear();
+    levelWidths.clear();
+    openTipsAtDepth.clear();
+    widest = 0;
+    tips = 0;
+    lazyTips = 0;
+    confirmed = 0;
+    orphans = 0;
+    clock = 0;
+    parentAgeHistogram.clear();
+    confirmationHistogram.clear();
+    approverHistogram.clear();
+}
+
+void DAGStatistics::writeMetrics(std::ostream& out, const std::string& prefix) const {
+    auto write = [&](const char* name, const char* type, const char* help, double value) {
+        out << "# HELP " << prefix << '_' << name << ' ' << help << '\n';
+        out << "# TYPE " << prefix << '_' << name << ' ' << type << '\n';
+        out << prefix << '_' << name << ' ' << value << '\n';
+    };
+
+    write("transactions_total", "counter", "Transactions attached to the DAG.", static_cast<double>(nodeCount()));
+    write("confirmed_total", "counter", "Transactions confirmed.", static_cast<double>(confirmed));
+    write("orphans_total", "counter", "Transactions retired without ever being confirmed.", static_cast<double>(orphans));
+    write("orphan_ratio", "gauge", "Orphaned share of transactions that were confirmed or orphaned.", orphanRate());
+    write("tips", "gauge", "Transactions without approvers.", static_cast<double>(tips));
+    write("lazy_tips", "gauge", "Unconfirmed tips too far below the deepest transaction to be approved.", static_cast<double>(lazyTips));
+    write("lazy_tip_ratio", "gauge", "Lazy share of the current tips.", lazyTipRate());
+    write("depth", "gauge", "Depth of the deepest transaction.", static_cast<double>(depth()));
+    write("width", "gauge", "Transactions at the deepest level.", static_cast<double>(width()));
+    write("max_width", "gauge", "Transactions at the widest level.", static_cast<double>(widest));
+    write("mean_width", "gauge", "Transactions per depth level.", meanWidth());
+
+    parentAgeHistogram.writeMetrics(out, prefix + "_parent_age_seconds", "Seconds between a transaction and each parent it approves.");
+    confirmationHistogram.writeMetrics(out, prefix + "_confirmation_seconds", "Seconds from a transaction's timestamp to its confirmation.");
+    approverHistogram.writeMetrics(out, prefix + "_approvers", "Direct approvers per transaction.");
+}
+
+size_t DAGStatistics::memoryUsage() const {
+    return timestamps.capacity() * sizeof(int64_t)
+        + (depths.capacity() + approverCounts.capacity()) * sizeof(uint32_t)
+        + flags.capacity()
+        + (levelWidths.capacity() + openTipsAtDepth.capacity()) * sizeof(size_t);
+}
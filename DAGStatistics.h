@@ -0,0 +1,132 @@
+#ifndef DAG_STATISTICS_H
+#define DAG_STATISTICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Histogram over fixed upper bounds, plus an overflow bucket. Buckets are
+// stored per bound and only made cumulative when written out.
+class StatHistogram {
+public:
+    explicit StatHistogram(std::vector<double> upperBounds);
+
+    void observe(double value);
+
+    // Undo one earlier observe(value), for distributions whose members move between buckets
+    void forget(double value);
+
+    uint64_t count() const { return total; }
+    double sum() const { return valueSum; }
+    double mean() const { return total == 0 ? 0.0 : valueSum / static_cast<double>(total); }
+
+    const std::vector<double>& bounds() const { return upperBounds; }
+    const std::vector<uint64_t>& bucketCounts() const { return buckets; }  // One more than bounds()
+
+    void clear();
+
+    // Prometheus text format: cumulative _bucket lines, then _sum and _count
+    void writeMetrics(std::ostream& out, const std::string& name, const std::string& help) const;
+
+private:
+    size_t bucketOf(double value) const;
+
+    std::vector<double> upperBounds;
+    std::vector<uint64_t> buckets;
+    uint64_t total = 0;
+    double valueSum = 0.0;
+};
+
+// Shape and health of the DAG, maintained incrementally from attach, tip,
+// confirmation and orphan events so every figure can be read in O(1) instead
+// of walking the graph. Nodes are identified by the DAG's dense ids and must
+// be recorded in id order, parents first.
+//
+// The clock is the newest transaction timestamp seen; parent ages and times to
+// confirmation are measured against transaction timestamps in seconds.
+class DAGStatistics {
+public:
+    DAGStatistics();
+
+    // A node joined the DAG; returns its id. Nodes loaded as already confirmed
+    // count as confirmed without contributing a time to confirmation.
+    uint32_t recordAttach(uint32_t depth, int64_t timestamp, const std::vector<uint32_t>& parentIds, bool confirmed);
+
+    void recordTipAdded(uint32_t id);
+    void recordTipRemoved(uint32_t id);
+    void recordConfirmation(uint32_t id);
+
+    // The checkpoint retired the node: never confirmed and no longer approvable
+    void recordOrphan(uint32_t id);
+
+    // Tips that many levels below the deepest node are lazy (see WalkConfig::maxTipAge)
+    void setMaxTipAge(uint32_t age);
+
+    void clear();
+
+    size_t nodeCount() const { return depths.size(); }
+    size_t tipCount() const { return tips; }
+    size_t confirmedCount() const { return confirmed; }
+    size_t orphanCount() const { return orphans; }
+
+    // Unconfirmed tips older than the lazy cutoff, and their share of all tips
+    size_t lazyTipCount() const { return lazyTips; }
+    double lazyTipRate() const { return tips == 0 ? 0.0 : static_cast<double>(lazyTips) / static_cast<double>(tips); }
+
+    // Orphaned share of the nodes whose fate is decided (confirmed or orphaned)
+    double orphanRate() const { return confirmed + orphans == 0 ? 0.0 : static_cast<double>(orphans) / static_cast<double>(confirmed + orphans); }
+
+    // Depth of the deepest node, and nodes per depth level: at the deepest level, the widest, and on average
+    uint32_t depth() const { return levelWidths.empty() ? 0 : static_cast<uint32_t>(levelWidths.size() - 1); }
+    size_t width() const { return levelWidths.empty() ? 0 : levelWidths.back(); }
+    size_t maxWidth() const { return widest; }
+    double meanWidth() const { return levelWidths.empty() ? 0.0 : static_cast<double>(depths.size()) / static_cast<double>(levelWidths.size()); }
+
+    // Seconds between a node and each parent it approves
+    const StatHistogram& parentAges() const { return parentAgeHistogram; }
+
+    // Seconds from a node's timestamp to its confirmation
+    const StatHistogram& confirmationTimes() const { return confirmationHistogram; }
+
+    // Direct approvers per node, over all nodes
+    const StatHistogram& approversPerNode() const { return approverHistogram; }
+
+    // Every figure above in Prometheus text format, names starting with prefix
+    void writeMetrics(std::ostream& out, const std::string& prefix = "xylonet_dag") const;
+
+    size_t memoryUsage() const;
+
+private:
+    static constexpr uint8_t tipFlag = 1;
+    static constexpr uint8_t confirmedFlag = 2;
+
+    bool isOpenTip(uint32_t id) const { return flags[id] == tipFlag; }
+    uint32_t lazyCutoff() const;
+    void openTipAdded(uint32_t id);
+    void openTipRemoved(uint32_t id);
+
+    // Per node id
+    std::vector<int64_t> timestamps;
+    std::vector<uint32_t> depths;
+    std::vector<uint32_t> approverCounts;
+    std::vector<uint8_t> flags;
+
+    std::vector<size_t> levelWidths;     // Nodes per depth
+    std::vector<size_t> openTipsAtDepth; // Unconfirmed tips per depth, for the lazy count
+    size_t widest = 0;
+
+    size_t tips = 0;
+    size_t lazyTips = 0;
+    size_t confirmed = 0;
+    size_t orphans = 0;
+    uint32_t maxTipAge = 50;
+    int64_t clock = 0;
+
+    StatHistogram parentAgeHistogram;
+    StatHistogram confirmationHistogram;
+    StatHistogram approverHistogram;
+};
+
+#endif // DAG_STATISTICS_H
@@ -0,0 +1,428 @@
+#include "IngestReactor.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const size_t readChunk = 64 * 1024;
+
+#ifndef _WIN32
+    bool setNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+#endif
+}
+
+IngestReactor::Task& IngestReactor::Task::operator=(Task&& other) noexcept {
+    if (this != &other) {
+        if (handle) {
+            handle.destroy();
+        }
+        handle = std::exchange(other.handle, nullptr);
+    }
+    return *this;
+}
+
+IngestReactor::Task::~Task() {
+    if (handle) {
+        handle.destroy();
+    }
+}
+
+IngestReactor::IngestReactor(BatchHandler handler, size_t batchSize)
+    : handler(std::move(handler)), batchSize(batchSize == 0 ? 1 : batchSize) {}
+
+IngestReactor::~IngestReactor() {
+    for (auto& source : sources) {
+        closeSource(*source);
+    }
+}
+
+IngestReactor::Source& IngestReactor::addSource(const std::string& name) {
+    sources.emplace_back(new Source());
+    sources.back()->name = name;
+    return *sources.back();
+}
+
+bool IngestReactor::addFile(const std::string& path) {
+#ifdef _WIN32
+    std::unique_ptr<std::ifstream> stream(new std::ifstream(path, std::ios::in | std::ios::binary));
+    if (!*stream) {
+        std::cerr << "Error opening ingest source '" << path << "'.\n";
+        return false;
+    }
+    Source& source = addSource(path);
+    source.stream = std::move(stream);
+#else
+    // O_NONBLOCK also keeps opening a FIFO from waiting for its writer
+    int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK);
+    if (fd < 0) {
+        std::cerr << "Error opening ingest source '" << path << "': " << std::strerror(errno) << "\n";
+        return false;
+    }
+    Source& source = addSource(path);
+    source.fd = fd;
+#endif
+    source.task = readLoop(source);
+    return true;
+}
+
+bool IngestReactor::addDescriptor(int fd, const std::string& name) {
+#ifdef _WIN32
+    (void)fd;
+    std::cerr << "Descriptor sources are not supported on this platform (" << name << ").\n";
+    return false;
+#else
+    if (fd < 0 || !setNonBlocking(fd)) {
+        std::cerr << "Error adding ingest source '" << name << "'.\n";
+        return false;
+    }
+    Source& source = addSource(name);
+    source.fd = fd;
+    source.task = readLoop(source);
+    return true;
+#endif
+}
+
+bool IngestReactor::connectUnix(const std::string& path) {
+#ifdef _WIN32
+    std::cerr << "Unix socket sources are not supported on this platform (" << path << ").\n";
+    return false;
+#else
+    sockaddr_un address;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path too long: " << path << "\n";
+        return false;
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+
+    Endpoint endpoint;
+    endpoint.family = AF_UNIX;
+    endpoint.socketType = SOCK_STREAM;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&address);
+    endpoint.address.assign(bytes, bytes + sizeof(address));
+
+    Source& source = addSource(path);
+    source.endpoints.push_back(std::move(endpoint));
+    source.task = connectAndRead(source);
+    return true;
+#endif
+}
+
+bool IngestReactor::connectTcp(const std::string& host, uint16_t port) {
+    std::string name = host + ":" + std::to_string(port);
+#ifdef _WIN32
+    std::cerr << "TCP sources are not supported on this platform (" << name << ").\n";
+    return false;
+#else
+    // getaddrinfo has no non-blocking form, so it runs on a helper thread while the reactor keeps turning
+    Source& source = addSource(name);
+    source.resolution = std::async(std::launch::async, [host, port]() {
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        std::vector<Endpoint> endpoints;
+        addrinfo* results = nullptr;
+        if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &results) != 0) {
+            return endpoints;
+        }
+        for (addrinfo* candidate = results; candidate; candidate = candidate->ai_next) {
+            Endpoint endpoint;
+            endpoint.family = candidate->ai_family;
+            endpoint.socketType = candidate->ai_socktype;
+            endpoint.protocol = candidate->ai_protocol;
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(candidate->ai_addr);
+            endpoint.address.assign(bytes, bytes + candidate->ai_addrlen);
+            endpoints.push_back(std::move(endpoint));
+        }
+        ::freeaddrinfo(results);
+        return endpoints;
+    });
+    source.task = connectAndRead(source);
+    return true;
+#endif
+}
+
+IngestReactor::Task IngestReactor::readLoop(Source& source) {
+    while (source.open) {
+        co_await Suspend{ source, Wait::Readable };
+        readSource(source);
+    }
+}
+
+IngestReactor::Task IngestReactor::connectAndRead(Source& source) {
+#ifndef _WIN32
+    if (source.resolution.valid()) {
+        co_await Suspend{ source, Wait::Resolved };
+        source.endpoints = source.resolution.get();
+        if (source.endpoints.empty()) {
+            std::cerr << "Error resolving '" << source.name << "'.\n";
+            co_return;
+        }
+    }
+
+    // Descriptors are non-blocking before connect, so a slow peer parks only this
+    // coroutine; completion shows up as writability, and SO_ERROR carries the outcome
+    int error = 0;
+    for (const Endpoint& endpoint : source.endpoints) {
+        int fd = ::socket(endpoint.family, endpoint.socketType, endpoint.protocol);
+        if (fd < 0) {
+            error = errno;
+            continue;
+        }
+        if (!setNonBlocking(fd)) {
+            error = errno;
+            ::close(fd);
+            continue;
+        }
+        source.fd = fd;
+
+        const sockaddr* address = reinterpret_cast<const sockaddr*>(endpoint.address.data());
+        socklen_t length = static_cast<socklen_t>(endpoint.address.size());
+        error = ::connect(fd, address, length) == 0 ? 0 : errno;
+        if (error == EINPROGRESS) {
+            co_await Suspend{ source, Wait::Writable };
+            socklen_t size = sizeof(error);
+            if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &size) != 0) {
+                error = errno;
+            }
+        }
+        if (error == 0) {
+            break;
+        }
+        ::close(fd);
+        source.fd = -1;
+    }
+    source.endpoints.clear();
+
+    if (source.fd < 0) {
+        std::cerr << "Error connecting to '" << source.name << "': " << std::strerror(error) << "\n";
+        co_return;
+    }
+
+    while (source.open) {
+        co_await Suspend{ source, Wait::Readable };
+        readSource(source);
+    }
+#else
+    co_return;
+#endif
+}
+
+void IngestReactor::resume(Source& source) {
+    source.wait = Wait::Turn;
+    source.task.resume();
+    if (source.task.done()) {
+        closeSource(source);
+    }
+}
+
+size_t IngestReactor::activeSources() const {
+    size_t active = 0;
+    for (const auto& source : sources) {
+        if (source->open) {
+            ++active;
+        }
+    }
+    return active;
+}
+
+size_t IngestReactor::pollOnce(int timeoutMs) {
+    decodedThisTurn = 0;
+
+    // Sources that need no descriptor event: newly added ones, finished
+    // resolutions, and streams that cannot be polled
+    bool resolving = false;
+    for (auto& source : sources) {
+        if (!source->open) {
+            continue;
+        }
+        if (source->wait == Wait::Resolved) {
+            if (source->resolution.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                resolving = true;
+                continue;
+            }
+            resume(*source);
+        }
+        else if (source->wait == Wait::Turn || (source->wait == Wait::Readable && source->fd < 0)) {
+            resume(*source);
+        }
+    }
+
+#ifndef _WIN32
+    std::vector<pollfd> descriptors;
+    std::vector<Source*> owners;
+    for (auto& source : sources) {
+        if (source->open && source->fd >= 0 && (source->wait == Wait::Readable || source->wait == Wait::Writable)) {
+            short events = source->wait == Wait::Readable ? POLLIN : POLLOUT;
+            descriptors.push_back(pollfd{ source->fd, events, 0 });
+            owners.push_back(source.get());
+        }
+    }
+
+    // Resolutions finish off the reactor thread, so check back on them soon
+    if (resolving) {
+        timeoutMs = timeoutMs < 0 ? 10 : std::min(timeoutMs, 10);
+    }
+    if (!descriptors.empty() || resolving) {
+        int ready = ::poll(descriptors.data(), static_cast<nfds_t>(descriptors.size()), timeoutMs);
+        if (ready < 0 && errno != EINTR) {
+            std::cerr << "poll failed: " << std::strerror(errno) << "\n";
+        }
+        for (size_t i = 0; ready > 0 && i < descriptors.size(); ++i) {
+            if (descriptors[i].revents & (POLLIN | POLLOUT | POLLHUP | POLLERR | POLLNVAL)) {
+                resume(*owners[i]);
+            }
+        }
+    }
+#else
+    (void)timeoutMs;
+    (void)resolving;
+#endif
+
+    flush();
+    return decodedThisTurn;
+}
+
+void IngestReactor::runUntilDrained(int timeoutMs) {
+    while (activeSources() > 0) {
+        pollOnce(timeoutMs);
+    }
+    flush();
+}
+
+bool IngestReactor::readSource(Source& source) {
+    char chunk[readChunk];
+    size_t received = 0;
+    bool endOfInput = false;
+
+#ifdef _WIN32
+    source.stream->read(chunk, sizeof(chunk));
+    received = static_cast<size_t>(source.stream->gcount());
+    endOfInput = !*source.stream;
+#else
+    ssize_t count = ::read(source.fd, chunk, sizeof(chunk));
+    if (count > 0) {
+        received = static_cast<size_t>(count);
+    }
+    else if (count == 0) {
+        endOfInput = true;
+    }
+    else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        std::cerr << "Error reading ingest source '" << source.name << "': " << std::strerror(errno) << "\n";
+        endOfInput = true;
+    }
+#endif
+
+    source.buffer.append(chunk, received);
+    decodeLines(source, endOfInput);
+    if (endOfInput) {
+        closeSource(source);
+    }
+    return received > 0;
+}
+
+void IngestReactor::decodeLines(Source& source, bool endOfInput) {
+    size_t start = 0;
+    size_t newline;
+    while ((newline = source.buffer.find('\n', start)) != std::string::npos) {
+        std::string line = source.buffer.substr(start, newline - start);
+        start = newline + 1;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        TransactionNode transaction;
+        if (decodeLine(line, transaction)) {
+            batch.push_back(std::move(transaction));
+            ++decoded;
+            ++decodedThisTurn;
+            if (batch.size() >= batchSize) {
+                flush();
+            }
+        }
+        else {
+            ++malformed;
+            std::cerr << "Malformed line from '" << source.name << "': " << line << "\n";
+        }
+    }
+    source.buffer.erase(0, start);
+
+    // A final line without a trailing newline still counts once the source ends
+    if (endOfInput && !source.buffer.empty()) {
+        source.buffer.push_back('\n');
+        decodeLines(source, false);
+    }
+}
+
+bool IngestReactor::decodeLine(const std::string& line, TransactionNode& transaction) const {
+    std::stringstream ss(line);
+    std::string id, sender, receiver, amountField, timestampField;
+    if (!(std::getline(ss, id, ',') && std::getline(ss, sender, ',') &&
+        std::getline(ss, receiver, ',') && std::getline(ss, amountField, ','))) {
+        return false;
+    }
+    std::getline(ss, timestampField, ',');
+
+    char* end = nullptr;
+    double amount = std::strtod(amountField.c_str(), &end);
+    if (id.empty() || sender.empty() || receiver.empty() || end == amountField.c_str() || amount <= 0.0) {
+        return false;
+    }
+
+    time_t timestamp = time(nullptr);
+    if (!timestampField.empty()) {
+        timestamp = static_cast<time_t>(std::strtoll(timestampField.c_str(), &end, 10));
+        if (end == timestampField.c_str()) {
+            return false;
+        }
+    }
+
+    transaction = TransactionNode(id, sender, receiver, amount, 0, timestamp, {}, false);
+    return true;
+}
+
+void IngestReactor::closeSource(Source& source) {
+    if (!source.open) {
+        return;
+    }
+    source.open = false;
+#ifndef _WIN32
+    if (source.fd >= 0) {
+        ::close(source.fd);
+        source.fd = -1;
+    }
+#endif
+    source.stream.reset();
+}
+
+void IngestReactor::flush() {
+    if (batch.empty()) {
+        return;
+    }
+    handler(batch);
+    batch.clear();
+}
@@ -0,0 +1,148 @@
+#ifndef INGEST_REACTOR_H
+#define INGEST_REACTOR_H
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "TransactionNode.h"
+
+// Single-threaded reactor that reads transactions from many sources at once.
+//
+// Every source is a non-blocking descriptor (file, FIFO, pipe, Unix or TCP
+// socket) multiplexed with poll(), and is driven by its own C++20 coroutine.
+// The coroutine suspends whenever it would block (waiting for input, for a
+// connect to complete, or for a host name to resolve), and the reactor resumes
+// it once poll() reports the descriptor ready. A slow source therefore never
+// stalls the others, and no thread is spent per source; only host name
+// resolution runs on a short-lived helper thread, since getaddrinfo blocks.
+//
+// Accepted line format: id,sender,receiver,amount[,timestamp]
+// Decoded transactions are handed to the batch handler in groups of up to
+// batchSize, or at the end of a reactor turn, whichever comes first. The
+// handler runs on the reactor thread, so while it waits (for example for
+// mempool space) every source is paused.
+//
+// On Windows only files are supported and are read a chunk per turn.
+class IngestReactor {
+public:
+    using BatchHandler = std::function<void(std::vector<TransactionNode>&)>;
+
+    explicit IngestReactor(BatchHandler handler, size_t batchSize = 256);
+    ~IngestReactor();
+
+    IngestReactor(const IngestReactor&) = delete;
+    IngestReactor& operator=(const IngestReactor&) = delete;
+
+    bool addFile(const std::string& path);
+    bool addDescriptor(int fd, const std::string& name);  // Takes ownership of fd
+
+    // Start connecting without blocking. Failures found later (resolution,
+    // refused connection) are reported on stderr and end the source.
+    bool connectUnix(const std::string& path);
+    bool connectTcp(const std::string& host, uint16_t port);
+
+    // One reactor turn: wait up to timeoutMs for input, decode it and flush the batch.
+    // Returns the number of transactions decoded.
+    size_t pollOnce(int timeoutMs);
+
+    // Synchronous adapter: keep turning until every source has reached end of input
+    void runUntilDrained(int timeoutMs = 100);
+
+    size_t activeSources() const;
+    uint64_t decodedCount() const { return decoded; }
+    uint64_t malformedCount() const { return malformed; }
+
+private:
+    // What a suspended source coroutine is waiting for
+    enum class Wait {
+        Turn,      // Nothing; resume on the next turn
+        Readable,
+        Writable,  // A non-blocking connect in progress
+        Resolved   // Host name resolution on the helper thread
+    };
+
+    // Coroutine driving one source. It starts suspended and is resumed only by
+    // the reactor; the frame is destroyed with its source.
+    class Task {
+    public:
+        struct promise_type {
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+
+        Task() = default;
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+        Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+        Task& operator=(Task&& other) noexcept;
+        ~Task();
+
+        bool done() const { return !handle || handle.done(); }
+        void resume() { handle.resume(); }
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    struct Endpoint {
+        int family = 0;
+        int socketType = 0;
+        int protocol = 0;
+        std::vector<unsigned char> address;  // sockaddr bytes
+    };
+
+    struct Source {
+        std::string name;
+        int fd = -1;
+        std::unique_ptr<std::ifstream> stream;  // Used where descriptors cannot be polled
+        std::string buffer;                     // Bytes of a line not yet terminated
+        bool open = true;
+        Wait wait = Wait::Turn;
+        std::vector<Endpoint> endpoints;        // Connect targets, tried in order
+        std::future<std::vector<Endpoint>> resolution;
+        Task task;                              // Last, so the frame goes before what it refers to
+    };
+
+    // Awaitable that records what the source waits for and suspends it
+    struct Suspend {
+        Source& source;
+        Wait wait;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<>) const noexcept { source.wait = wait; }
+        void await_resume() const noexcept {}
+    };
+
+    Task readLoop(Source& source);
+    Task connectAndRead(Source& source);
+    Source& addSource(const std::string& name);
+    void resume(Source& source);
+
+    bool readSource(Source& source);
+    void decodeLines(Source& source, bool endOfInput);
+    bool decodeLine(const std::string& line, TransactionNode& transaction) const;
+    void closeSource(Source& source);
+    void flush();
+
+    BatchHandler handler;
+    size_t batchSize;
+    std::vector<std::unique_ptr<Source>> sources;  // Stable addresses for the coroutine frames
+    std::vector<TransactionNode> batch;
+
+    uint64_t decoded = 0;
+    uint64_t malformed = 0;
+    size_t decodedThisTurn = 0;
+};
+
+#endif // INGEST_REACTOR_H
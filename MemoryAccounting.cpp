@@ -0,0 +1,41 @@
+#include "MemoryAccounting.h"
+
+MemoryCounters::MemoryCounters() {
+    for (size_t slot = 0; slot < static_cast<size_t>(MemorySubsystem::Count); ++slot) {
+        byteCounts[slot].store(0, std::memory_order_relaxed);
+        allocationCounts[slot].store(0, std::memory_order_relaxed);
+    }
+}
+
+const char* memorySubsystemName(MemorySubsystem subsystem) {
+    switch (subsystem) {
+    case MemorySubsystem::Transactions:
+        return "transactions";
+    case MemorySubsystem::Approvers:
+        return "adjList";
+    case MemorySubsystem::Weights:
+        return "cumulativeWeights";
+    default:
+        return "unknown";
+    }
+}
+
+void MemoryCounters::recordAllocation(MemorySubsystem subsystem, size_t bytes) {
+    size_t slot = static_cast<size_t>(subsystem);
+    byteCounts[slot].fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    allocationCounts[slot].fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryCounters::recordDeallocation(MemorySubsystem subsystem, size_t bytes) {
+    size_t slot = static_cast<size_t>(subsystem);
+    byteCounts[slot].fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    allocationCounts[slot].fetch_sub(1, std::memory_order_relaxed);
+}
+
+int64_t MemoryCounters::bytes(MemorySubsystem subsystem) const {
+    return byteCounts[static_cast<size_t>(subsystem)].load(std::memory_order_relaxed);
+}
+
+int64_t MemoryCounters::liveAllocations(MemorySubsystem subsystem) const {
+    return allocationCounts[static_cast<size_t>(subsystem)].load(std::memory_order_relaxed);
+}
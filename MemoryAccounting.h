@@ -0,0 +1,91 @@
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Subsystems whose container allocations are attributed separately
+enum class MemorySubsystem {
+    Transactions,  // The hash -> TransactionNode map
+    Approvers,     // The approver adjacency list
+    Weights,       // Cached cumulative weights
+    Count
+};
+
+const char* memorySubsystemName(MemorySubsystem subsystem);
+
+// Byte and allocation counters, one slot per subsystem. Each DAG owns one, so
+// its memory report only counts its own containers.
+class MemoryCounters {
+public:
+    MemoryCounters();
+    MemoryCounters(const MemoryCounters&) = delete;
+    MemoryCounters& operator=(const MemoryCounters&) = delete;
+
+    void recordAllocation(MemorySubsystem subsystem, size_t bytes);
+    void recordDeallocation(MemorySubsystem subsystem, size_t bytes);
+
+    int64_t bytes(MemorySubsystem subsystem) const;
+    int64_t liveAllocations(MemorySubsystem subsystem) const;
+
+private:
+    std::atomic<int64_t> byteCounts[static_cast<size_t>(MemorySubsystem::Count)];
+    std::atomic<int64_t> allocationCounts[static_cast<size_t>(MemorySubsystem::Count)];
+};
+
+// std::allocator replacement that attributes every allocation to a subsystem
+// of one MemoryCounters instance. A default-constructed allocator counts
+// nothing, and copies of a tracked container start out untracked, so only
+// the owner's containers show up in its counters. The allocator stays with
+// its container on assignment and swap; containers are only swapped within
+// the same owner.
+template <typename T, MemorySubsystem Subsystem>
+class TrackedAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = TrackedAllocator<U, Subsystem>;
+    };
+
+    TrackedAllocator() noexcept = default;
+    explicit TrackedAllocator(MemoryCounters* counters) noexcept : counters(counters) {}
+
+    template <typename U>
+    TrackedAllocator(const TrackedAllocator<U, Subsystem>& other) noexcept : counters(other.counters) {}
+
+    TrackedAllocator select_on_container_copy_construction() const noexcept { return TrackedAllocator(); }
+
+    T* allocate(size_t count) {
+        size_t bytes = count * sizeof(T);
+        T* pointer = static_cast<T*>(::operator new(bytes));
+        if (counters) {
+            counters->recordAllocation(Subsystem, bytes);
+        }
+        return pointer;
+    }
+
+    void deallocate(T* pointer, size_t count) noexcept {
+        if (counters) {
+            counters->recordDeallocation(Subsystem, count * sizeof(T));
+        }
+        ::operator delete(pointer);
+    }
+
+    template <typename U>
+    bool operator==(const TrackedAllocator<U, Subsystem>& other) const noexcept { return counters == other.counters; }
+
+    template <typename U>
+    bool operator!=(const TrackedAllocator<U, Subsystem>& other) const noexcept { return counters != other.counters; }
+
+private:
+    template <typename U, MemorySubsystem>
+    friend class TrackedAllocator;
+
+    MemoryCounters* counters = nullptr;
+};
+
+#endif // MEMORY_ACCOUNTING_H
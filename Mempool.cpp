@@ -0,0 +1,298 @@
+#include "Mempool.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    size_t parentOf(size_t index) {
+        return (index - 1) / 2;
+    }
+}
+
+Mempool::Mempool(DAG& dag, size_t capacity, double highWatermark)
+    : dag(dag), maxEntries(capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("Mempool capacity must be positive");
+    }
+    highWatermark = std::min(std::max(highWatermark, 0.0), 1.0);
+    highWatermarkEntries = std::max<size_t>(1, static_cast<size_t>(capacity * highWatermark));
+    heap.reserve(capacity);
+    slots.reserve(capacity);
+}
+
+double Mempool::priorityOf(const TransactionNode& transaction) {
+    // Rough serialized size: strings, three numeric fields and one hash per parent
+    size_t bytes = transaction.id.size() + transaction.senderAcc.size() + transaction.receiverAcc.size()
+        + transaction.hash.size() + 3 * sizeof(double) + transaction.parentHashes.size() * 16;
+    return transaction.fee / static_cast<double>(std::max<size_t>(bytes, 1));
+}
+
+// The DAG's fee is the floor: a sender may pay more to rank higher, never less
+void Mempool::assignFee(TransactionNode& transaction) const {
+    transaction.fee = std::max(transaction.fee, dag.calculateFee(transaction.amount));
+}
+
+AdmissionResult Mempool::submit(TransactionNode transaction) {
+    assignFee(transaction);
+    std::lock_guard<std::mutex> lock(mutex);
+    return admitLocked(transaction);
+}
+
+AdmissionResult Mempool::submitWait(TransactionNode transaction, std::chrono::milliseconds timeout) {
+    assignFee(transaction);
+    std::unique_lock<std::mutex> lock(mutex);
+    spaceAvailable.wait_for(lock, timeout, [this] { return heap.size() < highWatermarkEntries; });
+    return admitLocked(transaction);
+}
+
+AdmissionResult Mempool::admitLocked(TransactionNode& transaction) {
+    HeapKey key{ priorityOf(transaction), nextSequence, 0 };
+
+    AdmissionResult result = AdmissionResult::Accepted;
+    if (heap.size() >= highWatermarkEntries) {
+        // Above the watermark only transactions that outrank the current minimum get in
+        if (!lower(heap[0], key)) {
+            if (heap.size() >= maxEntries) {
+                ++rejected;
+                return AdmissionResult::Rejected;
+            }
+            return AdmissionResult::Backpressure;
+        }
+        if (heap.size() >= maxEntries) {
+            takeLocked(0);
+            ++evicted;
+            result = AdmissionResult::AcceptedWithEviction;
+        }
+    }
+
+    if (freeSlots.empty()) {
+        key.slot = static_cast<uint32_t>(slots.size());
+        slots.push_back(std::move(transaction));
+    }
+    else {
+        key.slot = freeSlots.back();
+        freeSlots.pop_back();
+        slots[key.slot] = std::move(transaction);
+    }
+
+    ++nextSequence;
+    ++admitted;
+    heap.push_back(key);
+    pushUp(heap.size() - 1);
+    return result;
+}
+
+TransactionNode Mempool::takeLocked(size_t heapIndex) {
+    uint32_t slot = heap[heapIndex].slot;
+    TransactionNode transaction = std::move(slots[slot]);
+    slots[slot] = TransactionNode();
+    freeSlots.push_back(slot);
+
+    heap[heapIndex] = heap.back();
+    heap.pop_back();
+    if (heapIndex < heap.size()) {
+        pushDown(heapIndex);
+    }
+    return transaction;
+}
+
+std::vector<TransactionNode> Mempool::drainBatch(size_t maxBatch) {
+    std::vector<TransactionNode> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch.reserve(std::min(maxBatch, heap.size()));
+        while (batch.size() < maxBatch && !heap.empty()) {
+            batch.push_back(takeLocked(maxIndex()));
+        }
+    }
+    spaceAvailable.notify_all();
+    return batch;
+}
+
+size_t Mempool::attachBatch(size_t maxBatch) {
+    std::vector<TransactionNode> batch = drainBatch(maxBatch);
+    size_t attached = 0;
+
+    // Fees were settled on admission, so attach directly rather than through
+    // DAG::addTransaction, which would charge the default fee again.
+    // Without approvable tips in the walk window (an empty DAG, or everything
+    // checkpointed) a shared snapshot would leave the whole batch parentless,
+    // so each transaction picks its parents after the previous one attached.
+    WalkSnapshot snapshot;
+    if (tipEngine) {
+        snapshot = dag.buildWalkSnapshot();
+    }
+    if (!tipEngine || !snapshot.hasTips()) {
+        for (auto& transaction : batch) {
+            transaction.parentHashes = dag.selectParentsMCMC(DAG::parentCount());
+            if (dag.attachTransaction(transaction)) {
+                ++attached;
+            }
+        }
+        return attached;
+    }
+
+    // Every transaction of the batch approves tips of the same snapshot
+    std::vector<std::vector<std::string>> parents =
+        tipEngine->selectBatch(snapshot, batch.size(), DAG::parentCount());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        batch[i].parentHashes = std::move(parents[i]);
+        if (dag.attachTransaction(batch[i])) {
+            ++attached;
+        }
+    }
+    return attached;
+}
+
+size_t Mempool::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return heap.size();
+}
+
+bool Mempool::isSaturated() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return heap.size() >= highWatermarkEntries;
+}
+
+uint64_t Mempool::admittedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return admitted;
+}
+
+uint64_t Mempool::evictedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return evicted;
+}
+
+uint64_t Mempool::rejectedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return rejected;
+}
+
+bool Mempool::isMinLevel(size_t index) {
+    size_t level = 0;
+    for (size_t n = index + 1; n > 1; n >>= 1) {
+        ++level;
+    }
+    return level % 2 == 0;
+}
+
+size_t Mempool::maxIndex() const {
+    if (heap.size() == 1) {
+        return 0;
+    }
+    if (heap.size() == 2 || lower(heap[2], heap[1])) {
+        return 1;
+    }
+    return 2;
+}
+
+void Mempool::pushUp(size_t index) {
+    if (index == 0) {
+        return;
+    }
+    size_t parent = parentOf(index);
+    if (isMinLevel(index)) {
+        if (lower(heap[parent], heap[index])) {
+            std::swap(heap[parent], heap[index]);
+            pushUpMax(parent);
+        }
+        else {
+            pushUpMin(index);
+        }
+    }
+    else {
+        if (lower(heap[index], heap[parent])) {
+            std::swap(heap[parent], heap[index]);
+            pushUpMin(parent);
+        }
+        else {
+            pushUpMax(index);
+        }
+    }
+}
+
+void Mempool::pushUpMin(size_t index) {
+    while (index > 2) {
+        size_t grandparent = parentOf(parentOf(index));
+        if (!lower(heap[index], heap[grandparent])) {
+            break;
+        }
+        std::swap(heap[index], heap[grandparent]);
+        index = grandparent;
+    }
+}
+
+void Mempool::pushUpMax(size_t index) {
+    while (index > 2) {
+        size_t grandparent = parentOf(parentOf(index));
+        if (!lower(heap[grandparent], heap[index])) {
+            break;
+        }
+        std::swap(heap[index], heap[grandparent]);
+        index = grandparent;
+    }
+}
+
+void Mempool::pushDown(size_t index) {
+    if (isMinLevel(index)) {
+        pushDownMin(index);
+    }
+    else {
+        pushDownMax(index);
+    }
+}
+
+void Mempool::pushDownMin(size_t index) {
+    while (2 * index + 1 < heap.size()) {
+        // Find the smallest among children and grandchildren
+        size_t smallest = 2 * index + 1;
+        size_t candidates[] = { 2 * index + 2, 4 * index + 3, 4 * index + 4, 4 * index + 5, 4 * index + 6 };
+        for (size_t candidate : candidates) {
+            if (candidate < heap.size() && lower(heap[candidate], heap[smallest])) {
+                smallest = candidate;
+            }
+        }
+
+        if (!lower(heap[smallest], heap[index])) {
+            return;
+        }
+        std::swap(heap[smallest], heap[index]);
+        if (smallest <= 2 * index + 2) {
+            return;  // Was a child, nothing below it to fix
+        }
+
+        size_t parent = parentOf(smallest);
+        if (lower(heap[parent], heap[smallest])) {
+            std::swap(heap[parent], heap[smallest]);
+        }
+        index = smallest;
+    }
+}
+
+void Mempool::pushDownMax(size_t index) {
+    while (2 * index + 1 < heap.size()) {
+        // Find the largest among children and grandchildren
+        size_t largest = 2 * index + 1;
+        size_t candidates[] = { 2 * index + 2, 4 * index + 3, 4 * index + 4, 4 * index + 5, 4 * index + 6 };
+        for (size_t candidate : candidates) {
+            if (candidate < heap.size() && lower(heap[largest], heap[candidate])) {
+                largest = candidate;
+            }
+        }
+
+        if (!lower(heap[index], heap[largest])) {
+            return;
+        }
+        std::swap(heap[largest], heap[index]);
+        if (largest <= 2 * index + 2) {
+            return;
+        }
+
+        size_t parent = parentOf(largest);
+        if (lower(heap[largest], heap[parent])) {
+            std::swap(heap[parent], heap[largest]);
+        }
+        index = largest;
+    }
+}
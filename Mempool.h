@@ -0,0 +1,119 @@
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "DAG.h"
+#include "TipSelectionEngine.h"
+#include "TransactionNode.h"
+
+// Outcome of offering a transaction to the mempool
+enum class AdmissionResult {
+    Accepted,              // Queued without displacing anything
+    AcceptedWithEviction,  // Queued after evicting the lowest-priority entry
+    Rejected,              // Pool is full and the transaction ranks below everything in it
+    Backpressure           // Pool is above its high watermark; not queued, the producer should slow down and retry
+};
+
+// Bounded, fee-prioritized staging area in front of DAG::addTransaction.
+//
+// Pending transactions are ordered by fee per byte in a min-max heap, so both
+// the best entry (to attach) and the worst entry (to evict) are O(log n). The
+// heap only moves small keys; the transactions themselves stay in fixed slots.
+//
+// Producers may call submit()/submitWait() from any thread. The attach stage
+// is a single consumer calling attachBatch(), which is the only code that
+// touches the DAG.
+//
+// Only Accepted and AcceptedWithEviction take the transaction. On Rejected or
+// Backpressure nothing is queued and the pool keeps no copy, so a producer that
+// wants the transaction attached must hold on to it and submit it again, either
+// after attachBatch() has made room or through submitWait(). Backpressure is
+// never counted as a rejection; it is the producer's cue to pause its source.
+class Mempool {
+public:
+    Mempool(DAG& dag, size_t capacity, double highWatermark = 0.9);
+
+    // Non-blocking admission. Every transaction pays at least DAG::calculateFee: a
+    // missing or lower fee is raised to it, and a higher fee set by the sender is
+    // kept and ranks the transaction.
+    AdmissionResult submit(TransactionNode transaction);
+
+    // Wait up to 'timeout' for the pool to drop below its high watermark before
+    // admitting; may still return Backpressure if the pool stays full
+    AdmissionResult submitWait(TransactionNode transaction, std::chrono::milliseconds timeout);
+
+    // Remove up to maxBatch transactions, highest priority first
+    std::vector<TransactionNode> drainBatch(size_t maxBatch);
+
+    // Drain a batch and attach it to the DAG; returns the number attached
+    size_t attachBatch(size_t maxBatch);
+
+    // Select parents for a whole batch at once with parallel walks over one
+    // snapshot instead of one serial selection per transaction; nullptr restores
+    // the serial path. Batches still take the serial path while the walk window
+    // has no approvable tips. The engine must outlive its use here.
+    void setTipSelectionEngine(TipSelectionEngine* engine) { tipEngine = engine; }
+
+    size_t size() const;
+    size_t capacity() const { return maxEntries; }
+    bool isSaturated() const;
+
+    uint64_t admittedCount() const;
+    uint64_t evictedCount() const;
+    uint64_t rejectedCount() const;
+
+    // Fee per estimated wire byte
+    static double priorityOf(const TransactionNode& transaction);
+
+private:
+    struct HeapKey {
+        double priority;
+        uint64_t sequence;  // Earlier submissions win ties
+        uint32_t slot;      // Index into 'slots'
+    };
+
+    static bool lower(const HeapKey& a, const HeapKey& b) {
+        if (a.priority != b.priority) {
+            return a.priority < b.priority;
+        }
+        return a.sequence > b.sequence;
+    }
+
+    void assignFee(TransactionNode& transaction) const;
+    AdmissionResult admitLocked(TransactionNode& transaction);
+    TransactionNode takeLocked(size_t heapIndex);
+
+    // Min-max heap maintenance: even levels hold minimums, odd levels maximums
+    static bool isMinLevel(size_t index);
+    size_t maxIndex() const;
+    void pushUp(size_t index);
+    void pushUpMin(size_t index);
+    void pushUpMax(size_t index);
+    void pushDown(size_t index);
+    void pushDownMin(size_t index);
+    void pushDownMax(size_t index);
+
+    DAG& dag;
+    TipSelectionEngine* tipEngine = nullptr;
+    size_t maxEntries;
+    size_t highWatermarkEntries;
+
+    std::vector<HeapKey> heap;
+    std::vector<TransactionNode> slots;
+    std::vector<uint32_t> freeSlots;
+    uint64_t nextSequence = 0;
+
+    uint64_t admitted = 0;
+    uint64_t evicted = 0;
+    uint64_t rejected = 0;
+
+    mutable std::mutex mutex;
+    std::condition_variable spaceAvailable;
+};
+
+#endif // MEMPOOL_H
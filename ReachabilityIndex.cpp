@@ -0,0 +1,200 @@
+#include "ReachabilityIndex.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+
+const size_t ReachabilityIndex::defaultWindow;
+const uint32_t ReachabilityIndex::noEdge;
+
+ReachabilityIndex::ReachabilityIndex(size_t window)
+    : windowBits(std::max<size_t>((window + 63) / 64, 1) * 64), wordsPerNode(windowBits / 64) {
+    clear();
+}
+
+uint32_t ReachabilityIndex::addNode(const std::vector<uint32_t>& parents) {
+    uint32_t id = static_cast<uint32_t>(size());
+    for (uint32_t parent : parents) {
+        if (parent >= id) {
+            throw std::invalid_argument("ReachabilityIndex: parent must be added before its child");
+        }
+    }
+
+    // A parent d ids below sets bit d - 1 and contributes its own bits shifted up by d
+    labels.resize(labels.size() + wordsPerNode, 0);
+    uint64_t* label = labels.data() + static_cast<size_t>(id) * wordsPerNode;
+    for (uint32_t parent : parents) {
+        size_t distance = id - parent;
+        if (distance > windowBits) {
+            continue;
+        }
+        label[(distance - 1) / 64] |= 1ULL << ((distance - 1) % 64);
+
+        const uint64_t* source = labels.data() + static_cast<size_t>(parent) * wordsPerNode;
+        size_t wordShift = distance / 64;
+        size_t bitShift = distance % 64;
+        for (size_t word = wordsPerNode; word-- > wordShift;) {
+            size_t from = word - wordShift;
+            uint64_t bits = source[from] << bitShift;
+            if (bitShift != 0 && from > 0) {
+                bits |= source[from - 1] >> (64 - bitShift);
+            }
+            label[word] |= bits;
+        }
+    }
+
+    for (uint32_t parent : parents) {
+        uint32_t edge = static_cast<uint32_t>(parentIds.size());
+        parentIds.push_back(parent);
+        edgeChild.push_back(id);
+        nextChildEdge.push_back(firstChildEdge[parent]);
+        firstChildEdge[parent] = edge;
+    }
+    parentOffsets.push_back(static_cast<uint32_t>(parentIds.size()));
+    firstChildEdge.push_back(noEdge);
+    return id;
+}
+
+bool ReachabilityIndex::windowReaches(uint32_t from, uint32_t to) const {
+    size_t bit = from - to - 1;
+    return (labels[static_cast<size_t>(from) * wordsPerNode + bit / 64] >> (bit % 64)) & 1;
+}
+
+bool ReachabilityIndex::reaches(uint32_t from, uint32_t to) const {
+    if (from >= size() || to > from) {
+        return false;
+    }
+    if (from == to) {
+        return true;
+    }
+    if (from - to <= windowBits) {
+        return windowReaches(from, to);
+    }
+    return searchReaches(from, to);
+}
+
+// Expand the smaller of two frontiers: ancestors of 'from' above 'to', and
+// descendants of 'to' below 'from'. A node within window range of the other
+// end answers for itself and everything behind it, so it is never expanded.
+bool ReachabilityIndex::searchReaches(uint32_t from, uint32_t to) const {
+    std::unordered_set<uint32_t> ancestors{ from };
+    std::unordered_set<uint32_t> descendants{ to };
+    std::vector<uint32_t> up{ from };
+    std::vector<uint32_t> down{ to };
+
+    while (!up.empty() && !down.empty()) {
+        if (up.size() <= down.size()) {
+            uint32_t node = up.back();
+            up.pop_back();
+            for (uint32_t edge = parentOffsets[node]; edge < parentOffsets[node + 1]; ++edge) {
+                uint32_t parent = parentIds[edge];
+                if (parent < to) {
+                    continue;
+                }
+                if (parent == to || descendants.count(parent)) {
+                    return true;
+                }
+                if (parent - to <= windowBits) {
+                    if (windowReaches(parent, to)) {
+                        return true;
+                    }
+                    continue;
+                }
+                if (ancestors.insert(parent).second) {
+                    up.push_back(parent);
+                }
+            }
+        }
+        else {
+            uint32_t node = down.back();
+            down.pop_back();
+            for (uint32_t edge = firstChildEdge[node]; edge != noEdge; edge = nextChildEdge[edge]) {
+                uint32_t child = edgeChild[edge];
+                if (child > from) {
+                    continue;
+                }
+                if (child == from || ancestors.count(child)) {
+                    return true;
+                }
+                if (from - child <= windowBits) {
+                    if (windowReaches(from, child)) {
+                        return true;
+                    }
+                    continue;
+                }
+                if (descendants.insert(child).second) {
+                    down.push_back(child);
+                }
+            }
+        }
+    }
+    return false;
+}
+
+size_t ReachabilityIndex::countPastCone(uint32_t node) const {
+    if (node >= size()) {
+        return 0;
+    }
+    std::vector<uint8_t> seen;
+    std::vector<uint32_t> pending{ node };
+    size_t total = 0;
+    while (!pending.empty()) {
+        uint32_t current = pending.back();
+        pending.pop_back();
+        for (uint32_t edge = parentOffsets[current]; edge < parentOffsets[current + 1]; ++edge) {
+            // Parents have smaller ids, so the seen flags only need to cover ids below the node
+            uint32_t parent = parentIds[edge];
+            size_t slot = node - parent - 1;
+            if (slot >= seen.size()) {
+                seen.resize(std::max(slot + 1, seen.size() * 2), 0);
+            }
+            if (!seen[slot]) {
+                seen[slot] = 1;
+                ++total;
+                pending.push_back(parent);
+            }
+        }
+    }
+    return total;
+}
+
+size_t ReachabilityIndex::countFutureCone(uint32_t node) const {
+    if (node >= size()) {
+        return 0;
+    }
+    std::vector<uint8_t> seen;
+    std::vector<uint32_t> pending{ node };
+    size_t total = 0;
+    while (!pending.empty()) {
+        uint32_t current = pending.back();
+        pending.pop_back();
+        for (uint32_t edge = firstChildEdge[current]; edge != noEdge; edge = nextChildEdge[edge]) {
+            // Children have larger ids, so the seen flags only need to cover ids above the node
+            uint32_t child = edgeChild[edge];
+            size_t slot = child - node - 1;
+            if (slot >= seen.size()) {
+                seen.resize(std::max(slot + 1, seen.size() * 2), 0);
+            }
+            if (!seen[slot]) {
+                seen[slot] = 1;
+                ++total;
+                pending.push_back(child);
+            }
+        }
+    }
+    return total;
+}
+
+size_t ReachabilityIndex::memoryUsage() const {
+    return labels.capacity() * sizeof(uint64_t)
+        + (parentOffsets.capacity() + parentIds.capacity() + edgeChild.capacity()
+            + nextChildEdge.capacity() + firstChildEdge.capacity()) * sizeof(uint32_t);
+}
+
+void ReachabilityIndex::clear() {
+    labels.clear();
+    parentOffsets.assign(1, 0);
+    parentIds.clear();
+    edgeChild.clear();
+    nextChildEdge.clear();
+    firstChildEdge.clear();
+}
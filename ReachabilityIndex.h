@@ -0,0 +1,72 @@
+#ifndef REACHABILITY_INDEX_H
+#define REACHABILITY_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Reachability labels for an append-only DAG, with a fixed size per node.
+//
+// Nodes are identified by dense ids in insertion order, and every node must be
+// added after all of its parents. Each node stores one bit for each of the
+// window ids just below its own: bit i is set if the node reaches id - 1 - i.
+// A child's bits are its parents' bits shifted by the id distance, so they are
+// built in O(window / 64) words per parent. They stay exact even when a parent
+// is older than the window.
+//
+// "Does A reach B" is a single bit test when B is within A's window, which is
+// where approval checks near the tips land. Farther targets fall back to a
+// bidirectional search over parent and child links. The window bits of every
+// visited node cut that search short. Memory is window / 8 bytes per node plus
+// 12 bytes per edge, however wide or orphan-heavy the DAG gets.
+//
+// Cone sizes are counted by a search over the cone, since no fixed-size label
+// can hold them exactly. For weights, the DAG's approximate mode keeps O(1)
+// future cone estimates (see WeightSketches).
+class ReachabilityIndex {
+public:
+    static const size_t defaultWindow = 512;
+
+    // window is rounded up to a multiple of 64
+    explicit ReachabilityIndex(size_t window = defaultWindow);
+
+    // Add the next node; returns its id
+    uint32_t addNode(const std::vector<uint32_t>& parents);
+
+    // True if 'from' equals 'to' or reaches it through parent links
+    bool reaches(uint32_t from, uint32_t to) const;
+
+    // Number of distinct ancestors / descendants of the node, excluding itself.
+    // Not O(1): each call searches the whole cone, so it costs O(cone size) time and
+    // scratch memory. Past cones are cheap for old nodes, future cones for recent ones.
+    // For repeated weight queries use WeightSketches, which answers in O(registers).
+    size_t countPastCone(uint32_t node) const;
+    size_t countFutureCone(uint32_t node) const;
+
+    size_t size() const { return firstChildEdge.size(); }
+    size_t window() const { return windowBits; }
+
+    // Approximate heap bytes held by the labels and links
+    size_t memoryUsage() const;
+
+    void clear();
+
+private:
+    static const uint32_t noEdge = UINT32_MAX;
+
+    // Exact answer for from - window <= to < from
+    bool windowReaches(uint32_t from, uint32_t to) const;
+    bool searchReaches(uint32_t from, uint32_t to) const;
+
+    size_t windowBits;
+    size_t wordsPerNode;
+
+    std::vector<uint64_t> labels;          // node -> wordsPerNode words of window bits
+    std::vector<uint32_t> parentOffsets;   // CSR parent lists, node -> [offset, next offset)
+    std::vector<uint32_t> parentIds;       // edge -> parent
+    std::vector<uint32_t> edgeChild;       // edge -> child (the node owning the edge)
+    std::vector<uint32_t> nextChildEdge;   // edge -> next edge with the same parent
+    std::vector<uint32_t> firstChildEdge;  // node -> most recent edge where it is the parent
+};
+
+#endif // REACHABILITY_INDEX_H
@@ -0,0 +1,271 @@
+#include "Simulator.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace {
+    // Derive an independent stream seed for one simulation component
+    uint64_t splitSeed(uint64_t seed, uint64_t component) {
+        uint64_t z = seed + 0x9e3779b97f4a7c15ULL * (component + 1);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+}
+
+double SimulationReport::orphanRate() const {
+    if (orphanCandidates == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(orphaned) / static_cast<double>(orphanCandidates);
+}
+
+double SimulationReport::latencyPercentile(double percentile) const {
+    if (confirmationLatencies.empty()) {
+        return 0.0;
+    }
+    double rank = percentile / 100.0 * static_cast<double>(confirmationLatencies.size() - 1);
+    size_t index = static_cast<size_t>(std::llround(rank));
+    return confirmationLatencies[std::min(index, confirmationLatencies.size() - 1)];
+}
+
+void SimulationReport::print(std::ostream& out) const {
+    out << "Simulation report\n";
+    out << "  Issued:      " << issued << "\n";
+    out << "  Attached:    " << attached << "\n";
+    out << "  Confirmed:   " << confirmed << "\n";
+    out << "  Orphan rate: " << std::fixed << std::setprecision(4) << orphanRate()
+        << " (" << orphaned << " of " << orphanCandidates << ")\n";
+
+    out << "  Confirmation latency (s): p50=" << latencyPercentile(50)
+        << " p90=" << latencyPercentile(90)
+        << " p99=" << latencyPercentile(99)
+        << " max=" << latencyPercentile(100) << "\n";
+
+    if (!tipPoolSamples.empty()) {
+        size_t minTips = tipPoolSamples.front().second;
+        size_t maxTips = minTips;
+        double totalTips = 0.0;
+        for (const auto& sample : tipPoolSamples) {
+            minTips = std::min(minTips, sample.second);
+            maxTips = std::max(maxTips, sample.second);
+            totalTips += static_cast<double>(sample.second);
+        }
+        out << "  Tip pool size: min=" << minTips << " mean="
+            << totalTips / static_cast<double>(tipPoolSamples.size())
+            << " max=" << maxTips << " final=" << tipPoolSamples.back().second << "\n";
+    }
+    if (weightSamples > 0) {
+        out << "  Weight estimate error: mean=" << 100.0 * weightMeanError << "% max="
+            << 100.0 * weightMaxError << "% over " << weightSamples << " unconfirmed transactions\n";
+    }
+    out << "  Reachability index: " << indexBytesPerTransaction << " bytes per transaction\n";
+    out.unsetf(std::ios::fixed);
+    out << std::setprecision(6);
+}
+
+Simulator::Simulator(const SimulationConfig& config)
+    : config(config),
+    arrivalRng(splitSeed(config.seed, 0)),
+    delayRng(splitSeed(config.seed, 1)),
+    payloadRng(splitSeed(config.seed, 2)),
+    epoch(1700000000) {
+    dag.seedRandom(splitSeed(config.seed, 3));
+    dag.setVerbose(false);
+    dag.setWalkConfig(config.walk);
+    dag.setWeightMode(config.weightMode, config.sketchPrecision);
+    if (!config.coldStorePrefix.empty()) {
+        dag.setColdStore(std::unique_ptr<TransactionStore>(new LsmTransactionStore(config.coldStorePrefix)), config.hotWindow);
+    }
+}
+
+void Simulator::schedule(double time, EventType type, size_t index) {
+    events.push(Event{ time, nextSequence++, type, index });
+}
+
+double Simulator::nextIssueDelay() {
+    std::exponential_distribution<double> distribution(config.issueRate);
+    return distribution(arrivalRng);
+}
+
+double Simulator::nextNetworkDelay() {
+    switch (config.delayDistribution) {
+    case DelayDistribution::Constant:
+        return config.meanDelay;
+    case DelayDistribution::Uniform: {
+        std::uniform_real_distribution<double> distribution(0.0, 2.0 * config.meanDelay);
+        return distribution(delayRng);
+    }
+    case DelayDistribution::Exponential:
+    default: {
+        if (config.meanDelay <= 0.0) {
+            return 0.0;
+        }
+        std::exponential_distribution<double> distribution(1.0 / config.meanDelay);
+        return distribution(delayRng);
+    }
+    }
+}
+
+SimulationReport Simulator::run() {
+    report = SimulationReport();
+    issuedPerIssuer.assign(config.numIssuers, 0);
+
+    if (config.issueRate > 0.0) {
+        for (size_t issuer = 0; issuer < config.numIssuers; ++issuer) {
+            schedule(nextIssueDelay(), EventType::Issue, issuer);
+        }
+    }
+    schedule(config.consensusInterval, EventType::Consensus, 0);
+    schedule(0.0, EventType::Sample, 0);
+    if (config.memoryReportInterval > 0.0) {
+        schedule(config.memoryReportInterval, EventType::MemoryReport, 0);
+    }
+    if (config.metricsInterval > 0.0) {
+        schedule(config.metricsInterval, EventType::Metrics, 0);
+    }
+
+    while (!events.empty()) {
+        Event event = events.top();
+        if (event.time > config.duration) {
+            break;
+        }
+        events.pop();
+
+        switch (event.type) {
+        case EventType::Issue:
+            handleIssue(event);
+            break;
+        case EventType::Arrive:
+            handleArrive(event);
+            break;
+        case EventType::Consensus:
+            handleConsensus(event);
+            break;
+        case EventType::Sample:
+            report.tipPoolSamples.emplace_back(event.time, dag.tipCount());
+            schedule(event.time + config.sampleInterval, EventType::Sample, 0);
+            break;
+        case EventType::MemoryReport:
+            std::cout << "[t=" << event.time << "s] ";
+            dag.memoryReport(std::cout);
+            schedule(event.time + config.memoryReportInterval, EventType::MemoryReport, 0);
+            break;
+        case EventType::Metrics:
+            std::cout << "# t=" << event.time << "s\n";
+            dag.getStatistics().writeMetrics(std::cout);
+            schedule(event.time + config.metricsInterval, EventType::Metrics, 0);
+            break;
+        }
+    }
+
+    // Same definition as the DAG's own statistics: orphaned means retired by the
+    // checkpoint, judged against every transaction whose fate is decided
+    const DAGStatistics& statistics = dag.getStatistics();
+    report.orphaned = statistics.orphanCount();
+    report.orphanCandidates = statistics.confirmedCount() + statistics.orphanCount();
+
+    if (config.weightMode == WeightMode::Approximate) {
+        measureWeightError();
+    }
+
+    const ReachabilityIndex& reachability = dag.getReachabilityIndex();
+    if (reachability.size() > 0) {
+        report.indexBytesPerTransaction = static_cast<double>(reachability.memoryUsage()) / static_cast<double>(reachability.size());
+    }
+
+    std::sort(report.confirmationLatencies.begin(), report.confirmationLatencies.end());
+    return report;
+}
+
+void Simulator::measureWeightError() {
+    const size_t maxSamples = 2000;
+    double totalError = 0.0;
+    for (const auto& pair : attachTimes) {
+        if (report.weightSamples == maxSamples) {
+            break;
+        }
+        // Estimates stop updating once a transaction is confirmed
+        if (dag.isConfirmed(pair.first)) {
+            continue;
+        }
+        double exact = static_cast<double>(dag.countFutureCone(pair.first) + 1);
+        double error = std::fabs(dag.currentWeight(pair.first) - exact) / exact;
+        totalError += error;
+        report.weightMaxError = std::max(report.weightMaxError, error);
+        ++report.weightSamples;
+    }
+    if (report.weightSamples > 0) {
+        report.weightMeanError = totalError / static_cast<double>(report.weightSamples);
+    }
+}
+
+void Simulator::handleIssue(const Event& event) {
+    size_t issuer = event.index;
+    uint64_t sequence = issuedPerIssuer[issuer]++;
+
+    std::uniform_int_distribution<size_t> receiverDistribution(0, config.numIssuers - 1);
+    std::uniform_real_distribution<double> amountDistribution(1.0, 2000.0);
+
+    PendingTransaction pending;
+    pending.issueTime = event.time;
+    pending.transaction = TransactionNode(
+        "sim" + std::to_string(issuer) + "x" + std::to_string(sequence),
+        "issuer" + std::to_string(issuer),
+        "issuer" + std::to_string(receiverDistribution(payloadRng)),
+        amountDistribution(payloadRng), 0,
+        epoch + static_cast<time_t>(event.time), {}, false);
+    pending.transaction.fee = dag.calculateFee(pending.transaction.amount);
+
+    // Parents are chosen from the issuer's view at issue time; the transaction
+    // itself only becomes visible once the network delay has elapsed
+    pending.transaction.parentHashes = dag.selectParentsMCMC(config.numParents);
+
+    size_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        inFlight[slot] = std::move(pending);
+    }
+    else {
+        slot = inFlight.size();
+        inFlight.push_back(std::move(pending));
+    }
+
+    ++report.issued;
+    schedule(event.time + nextNetworkDelay(), EventType::Arrive, slot);
+    schedule(event.time + nextIssueDelay(), EventType::Issue, issuer);
+}
+
+void Simulator::handleArrive(const Event& event) {
+    PendingTransaction& pending = inFlight[event.index];
+
+    if (dag.attachTransaction(pending.transaction)) {
+        ++report.attached;
+        unconfirmed[pending.transaction.hash] = pending.issueTime;
+        attachTimes[pending.transaction.hash] = event.time;
+    }
+
+    freeSlots.push_back(event.index);
+}
+
+void Simulator::handleConsensus(const Event& event) {
+    dag.performConsensus(config.validationThreshold);
+
+    // Retired transactions can never be confirmed, so they leave the watch list too
+    for (auto it = unconfirmed.begin(); it != unconfirmed.end();) {
+        if (dag.isConfirmed(it->first)) {
+            report.confirmationLatencies.push_back(event.time - it->second);
+            ++report.confirmed;
+            it = unconfirmed.erase(it);
+        }
+        else if (dag.isRetired(it->first)) {
+            it = unconfirmed.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    schedule(event.time + config.consensusInterval, EventType::Consensus, 0);
+}
@@ -0,0 +1,136 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <cstdint>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "DAG.h"
+#include "TransactionNode.h"
+
+// Shape of the network delay between issuing a transaction and it becoming visible
+enum class DelayDistribution {
+    Constant,
+    Uniform,
+    Exponential
+};
+
+struct SimulationConfig {
+    size_t numIssuers = 1000;           // Number of virtual issuers
+    double issueRate = 0.01;            // Transactions per second per issuer (Poisson arrivals)
+    DelayDistribution delayDistribution = DelayDistribution::Exponential;
+    double meanDelay = 0.5;             // Mean network delay in seconds
+    size_t numParents = 3;              // Parents selected per transaction
+    double validationThreshold = 5.0;   // Threshold passed to DAG::performConsensus
+    double consensusInterval = 1.0;     // Seconds between consensus passes
+    double duration = 600.0;            // Simulated seconds
+    double sampleInterval = 1.0;        // Seconds between tip pool samples
+    double memoryReportInterval = 0.0;  // Seconds between DAG memory reports on stdout, 0 to disable
+    double metricsInterval = 0.0;       // Seconds between DAG statistics dumps (Prometheus text) on stdout, 0 to disable
+    uint64_t seed = 1;                  // Master seed, split into one stream per component
+    WalkConfig walk;                    // Tip selection entry depth, lazy tip age and bias
+    std::string coldStorePrefix;        // Spill frozen history to <prefix>.run<n> files, empty to keep it in memory
+    size_t hotWindow = 4096;            // Most recent frozen transactions kept in memory
+    WeightMode weightMode = WeightMode::Exact;
+    unsigned sketchPrecision = 7;       // log2 of HyperLogLog registers per node in Approximate mode
+};
+
+struct SimulationReport {
+    size_t issued = 0;
+    size_t attached = 0;
+    size_t confirmed = 0;
+    size_t orphaned = 0;                                  // Retired by the checkpoint without being confirmed
+    size_t orphanCandidates = 0;                          // Transactions confirmed or orphaned
+    std::vector<double> confirmationLatencies;           // Seconds from issue to confirmation, sorted
+    std::vector<std::pair<double, size_t>> tipPoolSamples; // (simulated time, tip count)
+
+    // Approximate mode only: relative error of the weight estimates against exact
+    // future cone sizes, over unconfirmed transactions at the end of the run
+    size_t weightSamples = 0;
+    double weightMeanError = 0.0;
+    double weightMaxError = 0.0;
+
+    // Reachability index bytes per attached transaction at the end of the run; must
+    // stay flat as runs get longer (see tests/SimulatorScalingTest.cpp)
+    double indexBytesPerTransaction = 0.0;
+
+    double orphanRate() const;
+    double latencyPercentile(double percentile) const;
+    void print(std::ostream& out) const;
+};
+
+// Deterministic discrete-event simulation of many issuers attaching to one DAG.
+// Every random decision comes from a per-component generator derived from the
+// master seed, so the same config always produces the same report.
+class Simulator {
+public:
+    explicit Simulator(const SimulationConfig& config);
+
+    SimulationReport run();
+
+    const DAG& getDAG() const { return dag; }
+
+private:
+    enum class EventType {
+        Issue,       // An issuer creates a transaction and picks its parents
+        Arrive,      // The transaction reaches the network and is attached
+        Consensus,   // Periodic consensus pass and confirmation bookkeeping
+        Sample,      // Periodic tip pool sample
+        MemoryReport, // Periodic DAG memory report
+        Metrics       // Periodic DAG statistics dump
+    };
+
+    struct Event {
+        double time;
+        uint64_t sequence;  // Tie breaker so equal-time events keep insertion order
+        EventType type;
+        size_t index;       // Issuer for Issue, in-flight slot for Arrive
+
+        bool operator>(const Event& other) const {
+            if (time != other.time) {
+                return time > other.time;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    struct PendingTransaction {
+        TransactionNode transaction;
+        double issueTime;
+    };
+
+    void schedule(double time, EventType type, size_t index);
+    double nextIssueDelay();
+    double nextNetworkDelay();
+
+    void handleIssue(const Event& event);
+    void handleArrive(const Event& event);
+    void handleConsensus(const Event& event);
+    void measureWeightError();
+
+    SimulationConfig config;
+    DAG dag;
+
+    std::mt19937_64 arrivalRng;
+    std::mt19937_64 delayRng;
+    std::mt19937_64 payloadRng;
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    uint64_t nextSequence = 0;
+
+    std::vector<PendingTransaction> inFlight;
+    std::vector<size_t> freeSlots;
+    std::vector<uint64_t> issuedPerIssuer;
+
+    std::unordered_map<std::string, double> unconfirmed;  // hash -> issue time
+    std::unordered_map<std::string, double> attachTimes;  // hash -> attach time
+
+    time_t epoch;
+    SimulationReport report;
+};
+
+#endif // SIMULATOR_H
@@ -0,0 +1,155 @@
+#include "TipSelectionEngine.h"
+#include <algorithm>
+
+const uint32_t WalkSnapshot::none;
+
+TipSelectionEngine::TipSelectionEngine(unsigned threads, size_t reuseLimit, uint64_t seed)
+    : reuseLimit(reuseLimit == 0 ? 1 : reuseLimit), nextSeed(seed) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(&TipSelectionEngine::workerLoop, this);
+    }
+}
+
+TipSelectionEngine::~TipSelectionEngine() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void TipSelectionEngine::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void TipSelectionEngine::runWalks(const WalkSnapshot& snapshot, uint64_t batchSeed, size_t first, size_t count,
+    std::vector<uint32_t>& results) {
+    results.assign(count, WalkSnapshot::none);
+    if (count == 0) {
+        return;
+    }
+
+    size_t chunks = std::min(count, workers.size());
+    size_t chunkSize = (count + chunks - 1) / chunks;
+    size_t remaining = 0;
+    std::mutex doneMutex;
+    std::condition_variable done;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t start = 0; start < count; start += chunkSize) {
+            size_t stop = std::min(count, start + chunkSize);
+            ++remaining;
+            tasks.push_back([&, start, stop] {
+                for (size_t i = start; i < stop; ++i) {
+                    // Each walk gets its own stream, keyed by its index within the batch
+                    SplitMix64 seeder(batchSeed ^ ((first + i) * 0xd1b54a32d192ed03ULL));
+                    SplitMix64 rng(seeder());
+                    results[i] = snapshot.walk(rng);
+                }
+                std::lock_guard<std::mutex> doneLock(doneMutex);
+                if (--remaining == 0) {
+                    done.notify_one();
+                }
+            });
+        }
+    }
+    taskAvailable.notify_all();
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    done.wait(lock, [&remaining] { return remaining == 0; });
+    walks += count;
+}
+
+std::vector<std::vector<std::string>> TipSelectionEngine::selectBatch(const WalkSnapshot& snapshot,
+    size_t transactions, size_t parentsPerTransaction) {
+    std::vector<std::vector<std::string>> selection(transactions);
+    if (snapshot.empty() || parentsPerTransaction == 0) {
+        return selection;
+    }
+
+    uint64_t batchSeed = SplitMix64(nextSeed++)();
+
+    // Walk results not yet used reuseLimit times, handed out round robin
+    struct Offer {
+        uint32_t tip;
+        size_t usesLeft;
+    };
+    std::deque<Offer> offers;
+    std::vector<Offer> skipped;
+    std::vector<uint32_t> results;
+
+    // Walks can keep failing on lazy tips or landing on the same few tips; give up eventually
+    const size_t demand = transactions * parentsPerTransaction;
+    const size_t maxWalks = 8 * demand + 64;
+    size_t walksRun = 0;
+
+    std::vector<uint32_t> chosen;
+    for (size_t t = 0; t < transactions; ++t) {
+        chosen.clear();
+        while (chosen.size() < parentsPerTransaction) {
+            bool taken = false;
+            while (!offers.empty()) {
+                Offer offer = offers.front();
+                offers.pop_front();
+                if (std::find(chosen.begin(), chosen.end(), offer.tip) != chosen.end()) {
+                    skipped.push_back(offer);
+                    continue;
+                }
+                chosen.push_back(offer.tip);
+                if (--offer.usesLeft > 0) {
+                    offers.push_back(offer);
+                }
+                taken = true;
+                break;
+            }
+            for (auto it = skipped.rbegin(); it != skipped.rend(); ++it) {
+                offers.push_front(*it);
+            }
+            skipped.clear();
+            if (taken) {
+                continue;
+            }
+
+            if (walksRun >= maxWalks) {
+                break;
+            }
+            // Enough fresh walks for the rest of the batch; the floor is fixed rather
+            // than per worker so the walk sequence is the same for any thread count
+            size_t outstanding = demand - t * parentsPerTransaction - chosen.size();
+            size_t count = std::max((outstanding + reuseLimit - 1) / reuseLimit, static_cast<size_t>(32));
+            count = std::min(count, maxWalks - walksRun);
+            runWalks(snapshot, batchSeed, walksRun, count, results);
+            walksRun += count;
+            for (uint32_t tip : results) {
+                if (tip != WalkSnapshot::none) {
+                    offers.push_back(Offer{ tip, reuseLimit });
+                }
+            }
+        }
+
+        selection[t].reserve(chosen.size());
+        for (uint32_t tip : chosen) {
+            selection[t].push_back(snapshot.hashes[tip]);
+        }
+    }
+    return selection;
+}
@@ -0,0 +1,128 @@
+#ifndef TIP_SELECTION_ENGINE_H
+#define TIP_SELECTION_ENGINE_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Small, fast generator for per-walk random streams (splitmix64)
+class SplitMix64 {
+public:
+    using result_type = uint64_t;
+
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t state;
+};
+
+// Immutable view of the walk window (every node at or above the walk entry
+// depth), built by BasicDAG::buildWalkSnapshot. Approvers are stored as CSR
+// arrays of local indices, each with a cumulative transition weight, so a
+// step is one binary search and walks never touch the DAG's hash maps.
+struct WalkSnapshot {
+    static const uint32_t none = std::numeric_limits<uint32_t>::max();
+
+    std::vector<std::string> hashes;        // Local index -> transaction hash
+    std::vector<uint32_t> approverOffsets;  // Local index -> [offset, next offset) into approvers
+    std::vector<uint32_t> approvers;
+    std::vector<double> transitions;        // Running sum of transition weights, parallel to approvers
+    std::vector<uint32_t> entries;          // Local indices walks start from
+    std::vector<uint8_t> selectable;        // Tips that may be approved (not lazy)
+    size_t maxSteps = 1000;
+
+    bool empty() const { return entries.empty(); }
+
+    // False if no walk can end on an approvable tip
+    bool hasTips() const { return !empty() && std::find(selectable.begin(), selectable.end(), 1) != selectable.end(); }
+
+    // One walk from a random entry to a tip; 'none' if it ends on a lazy tip
+    template <typename Rng>
+    uint32_t walk(Rng& rng) const;
+};
+
+// Runs many independent walks on a thread pool over one snapshot and hands
+// the resulting tips out to a batch of transactions. Every walk result may be
+// used by up to reuseLimit transactions of the batch, so a batch of n
+// transactions with k parents needs about n * k / reuseLimit walks instead of
+// n * k. Walk i of a batch draws from its own stream derived from the batch
+// seed, so results do not depend on the number of threads or on scheduling.
+class TipSelectionEngine {
+public:
+    explicit TipSelectionEngine(unsigned threads = 0, size_t reuseLimit = 2, uint64_t seed = 1);
+    ~TipSelectionEngine();
+
+    TipSelectionEngine(const TipSelectionEngine&) = delete;
+    TipSelectionEngine& operator=(const TipSelectionEngine&) = delete;
+
+    void setReuseLimit(size_t limit) { reuseLimit = limit == 0 ? 1 : limit; }
+    size_t getReuseLimit() const { return reuseLimit; }
+    unsigned threadCount() const { return static_cast<unsigned>(workers.size()); }
+
+    // Distinct parents for each of 'transactions' transactions; a transaction gets
+    // fewer than parentsPerTransaction parents only if the snapshot lacks enough tips.
+    // One caller at a time; the parallelism is inside.
+    std::vector<std::vector<std::string>> selectBatch(const WalkSnapshot& snapshot,
+        size_t transactions, size_t parentsPerTransaction);
+
+    uint64_t walkCount() const { return walks; }
+
+private:
+    // Run walks [first, first + count) of the current batch in parallel
+    void runWalks(const WalkSnapshot& snapshot, uint64_t batchSeed, size_t first, size_t count,
+        std::vector<uint32_t>& results);
+    void workerLoop();
+
+    size_t reuseLimit;
+    uint64_t nextSeed;
+    uint64_t walks = 0;
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    bool stopping = false;
+};
+
+template <typename Rng>
+uint32_t WalkSnapshot::walk(Rng& rng) const {
+    if (entries.empty()) {
+        return none;
+    }
+    uint32_t current = entries[std::uniform_int_distribution<size_t>(0, entries.size() - 1)(rng)];
+    for (size_t step = 0; step < maxSteps; ++step) {
+        uint32_t first = approverOffsets[current];
+        uint32_t last = approverOffsets[current + 1];
+        if (first == last) {
+            return selectable[current] ? current : none;
+        }
+
+        // Transitions restart from zero at each node, so the last one is the node's total
+        double target = std::uniform_real_distribution<double>(0.0, transitions[last - 1])(rng);
+        auto chosen = std::upper_bound(transitions.begin() + first, transitions.begin() + last, target);
+        size_t choice = std::min(static_cast<size_t>(chosen - transitions.begin()), static_cast<size_t>(last - 1));
+        current = approvers[choice];
+    }
+    return none;
+}
+
+#endif // TIP_SELECTION_ENGINE_H
@@ -0,0 +1,638 @@
+#include "TransactionArchive.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    const char headerMagic[8] = { 'X', 'Y', 'L', 'A', 'R', 'C', '0', '1' };
+    const char footerMagic[8] = { 'X', 'Y', 'L', 'A', 'E', 'N', 'D', '1' };
+
+    const uint8_t flagBinaryHash = 1;
+    const uint8_t flagValidated = 2;
+
+    const size_t minMatch = 4;
+    const size_t hashBits = 14;
+
+    void putFixed(std::vector<uint8_t>& out, uint64_t value, size_t bytes) {
+        for (size_t i = 0; i < bytes; ++i) {
+            out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    bool getFixed(const uint8_t*& data, const uint8_t* end, uint64_t& value, size_t bytes) {
+        if (static_cast<size_t>(end - data) < bytes) {
+            return false;
+        }
+        value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(data[i]) << (8 * i);
+        }
+        data += bytes;
+        return true;
+    }
+
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // Hashes from generateHash are lowercase hex without leading zeros and fit in 64 bits
+    bool parseHexHash(const std::string& hash, uint64_t& value) {
+        if (hash.empty() || hash.size() > 16 || (hash.size() > 1 && hash[0] == '0')) {
+            return false;
+        }
+        value = 0;
+        for (char c : hash) {
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= static_cast<uint64_t>(c - '0');
+            }
+            else if (c >= 'a' && c <= 'f') {
+                value |= static_cast<uint64_t>(c - 'a' + 10);
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string formatHexHash(uint64_t value) {
+        static const char digits[] = "0123456789abcdef";
+        char buffer[16];
+        size_t length = 0;
+        do {
+            buffer[length++] = digits[value & 0xF];
+            value >>= 4;
+        } while (value != 0);
+        std::reverse(buffer, buffer + length);
+        return std::string(buffer, length);
+    }
+
+    void putHash(std::vector<uint8_t>& out, const std::string& hash) {
+        uint64_t value;
+        if (parseHexHash(hash, value)) {
+            out.push_back(0);
+            putFixed(out, value, 8);
+        }
+        else {
+            out.push_back(1);
+            BlockCodec::putString(out, hash);
+        }
+    }
+
+    bool getHash(const uint8_t*& data, const uint8_t* end, std::string& hash) {
+        if (data >= end) {
+            return false;
+        }
+        uint8_t tag = *data++;
+        if (tag == 0) {
+            uint64_t value;
+            if (!getFixed(data, end, value, 8)) {
+                return false;
+            }
+            hash = formatHexHash(value);
+            return true;
+        }
+        return tag == 1 && BlockCodec::getString(data, end, hash);
+    }
+
+    // Amounts with at most six decimals become zigzag varints; anything else keeps its raw bits
+    void putAmount(std::vector<uint8_t>& out, double value) {
+        double scaled = value * 1000000.0;
+        if (std::fabs(scaled) < 1e18) {
+            int64_t fixed = static_cast<int64_t>(std::llround(scaled));
+            if (static_cast<double>(fixed) / 1000000.0 == value && (fixed >> 61) == (fixed >> 63)) {
+                BlockCodec::putVarint(out, zigzag(fixed) << 1);
+                return;
+            }
+        }
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        BlockCodec::putVarint(out, 1);
+        putFixed(out, bits, 8);
+    }
+
+    bool getAmount(const uint8_t*& data, const uint8_t* end, double& value) {
+        uint64_t tag;
+        if (!BlockCodec::getVarint(data, end, tag)) {
+            return false;
+        }
+        if ((tag & 1) == 0) {
+            value = static_cast<double>(unzigzag(tag >> 1)) / 1000000.0;
+            return true;
+        }
+        uint64_t bits;
+        if (!getFixed(data, end, bits, 8)) {
+            return false;
+        }
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    uint32_t read32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    void putLength(std::vector<uint8_t>& out, size_t length) {
+        while (length >= 255) {
+            out.push_back(255);
+            length -= 255;
+        }
+        out.push_back(static_cast<uint8_t>(length));
+    }
+
+    bool getLength(const uint8_t*& data, const uint8_t* end, size_t& length) {
+        uint8_t byte;
+        do {
+            if (data >= end) {
+                return false;
+            }
+            byte = *data++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    // One LZ sequence: token (literal length, match length - 4), literals, then offset and match
+    void emitSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalLength,
+        size_t offset, size_t matchLength) {
+        size_t matchCode = matchLength ? matchLength - minMatch : 0;
+        uint8_t token = static_cast<uint8_t>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15));
+        out.push_back(token);
+        if (literalLength >= 15) {
+            putLength(out, literalLength - 15);
+        }
+        out.insert(out.end(), literals, literals + literalLength);
+        if (matchLength == 0) {
+            return;  // Final literal run
+        }
+        out.push_back(static_cast<uint8_t>(offset));
+        out.push_back(static_cast<uint8_t>(offset >> 8));
+        if (matchCode >= 15) {
+            putLength(out, matchCode - 15);
+        }
+    }
+}
+
+namespace BlockCodec {
+
+    void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool getVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (data >= end) {
+                return false;
+            }
+            uint8_t byte = *data++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void putString(std::vector<uint8_t>& out, const std::string& value) {
+        putVarint(out, value.size());
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    bool getString(const uint8_t*& data, const uint8_t* end, std::string& value) {
+        uint64_t length;
+        if (!getVarint(data, end, length) || length > static_cast<uint64_t>(end - data)) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(data), static_cast<size_t>(length));
+        data += length;
+        return true;
+    }
+
+    std::vector<uint8_t> compress(const std::vector<uint8_t>& input) {
+        std::vector<uint8_t> out;
+        out.reserve(input.size() / 2 + 16);
+
+        const uint8_t* base = input.data();
+        size_t size = input.size();
+        size_t anchor = 0;
+
+        if (size > minMatch + 5) {
+            std::vector<uint32_t> table(static_cast<size_t>(1) << hashBits, UINT32_MAX);
+            size_t limit = size - 5;  // Keep the tail as literals so matches never overrun
+
+            size_t i = 0;
+            while (i + minMatch <= limit) {
+                uint32_t sequence = read32(base + i);
+                uint32_t slot = (sequence * 2654435761u) >> (32 - hashBits);
+                uint32_t candidate = table[slot];
+                table[slot] = static_cast<uint32_t>(i);
+
+                if (candidate == UINT32_MAX || i - candidate > 65535 || read32(base + candidate) != sequence) {
+                    ++i;
+                    continue;
+                }
+
+                size_t length = minMatch;
+                while (i + length < limit && base[candidate + length] == base[i + length]) {
+                    ++length;
+                }
+
+                emitSequence(out, base + anchor, i - anchor, i - candidate, length);
+                i += length;
+                anchor = i;
+            }
+        }
+
+        emitSequence(out, base + anchor, size - anchor, 0, 0);
+        return out;
+    }
+
+    bool decompress(const uint8_t* data, size_t size, size_t rawSize, std::vector<uint8_t>& output) {
+        output.clear();
+        output.reserve(rawSize);
+        const uint8_t* end = data + size;
+
+        while (data < end) {
+            uint8_t token = *data++;
+
+            size_t literalLength = token >> 4;
+            if (literalLength == 15 && !getLength(data, end, literalLength)) {
+                return false;
+            }
+            if (literalLength > static_cast<size_t>(end - data) || output.size() + literalLength > rawSize) {
+                return false;
+            }
+            output.insert(output.end(), data, data + literalLength);
+            data += literalLength;
+
+            if (data == end) {
+                break;  // Final literal run has no match
+            }
+
+            if (end - data < 2) {
+                return false;
+            }
+            size_t offset = data[0] | (static_cast<size_t>(data[1]) << 8);
+            data += 2;
+
+            size_t matchLength = token & 0xF;
+            if (matchLength == 15 && !getLength(data, end, matchLength)) {
+                return false;
+            }
+            matchLength += minMatch;
+
+            if (offset == 0 || offset > output.size() || output.size() + matchLength > rawSize) {
+                return false;
+            }
+            // Byte-wise copy so overlapping matches repeat correctly
+            size_t from = output.size() - offset;
+            for (size_t k = 0; k < matchLength; ++k) {
+                output.push_back(output[from + k]);
+            }
+        }
+
+        return output.size() == rawSize;
+    }
+
+    std::vector<uint8_t> encodeBlock(const std::vector<const TransactionNode*>& transactions) {
+        std::vector<uint8_t> out;
+
+        // Account dictionary in first-use order
+        std::unordered_map<std::string, uint64_t> accountIds;
+        std::vector<const std::string*> accounts;
+        for (const TransactionNode* t : transactions) {
+            for (const std::string* account : { &t->senderAcc, &t->receiverAcc }) {
+                if (accountIds.emplace(*account, accounts.size()).second) {
+                    accounts.push_back(account);
+                }
+            }
+        }
+
+        putVarint(out, transactions.size());
+        putVarint(out, accounts.size());
+        for (const std::string* account : accounts) {
+            putString(out, *account);
+        }
+
+        std::unordered_map<std::string, uint64_t> positions;
+        int64_t previousTimestamp = 0;
+        for (size_t i = 0; i < transactions.size(); ++i) {
+            const TransactionNode& t = *transactions[i];
+
+            uint64_t hashValue;
+            bool binaryHash = parseHexHash(t.hash, hashValue);
+            out.push_back(static_cast<uint8_t>((binaryHash ? flagBinaryHash : 0) | (t.isValidated ? flagValidated : 0)));
+            if (binaryHash) {
+                putFixed(out, hashValue, 8);
+            }
+            else {
+                putString(out, t.hash);
+            }
+
+            putString(out, t.id);
+            putVarint(out, accountIds[t.senderAcc]);
+            putVarint(out, accountIds[t.receiverAcc]);
+            putAmount(out, t.amount);
+            putAmount(out, t.fee);
+
+            int64_t timestamp = static_cast<int64_t>(t.timestamp);
+            putVarint(out, zigzag(timestamp - previousTimestamp));
+            previousTimestamp = timestamp;
+
+            putVarint(out, t.parentHashes.size());
+            for (const auto& parent : t.parentHashes) {
+                auto it = positions.find(parent);
+                if (it != positions.end()) {
+                    putVarint(out, i - it->second);
+                }
+                else {
+                    putVarint(out, 0);
+                    putHash(out, parent);
+                }
+            }
+
+            positions[t.hash] = i;
+        }
+
+        return out;
+    }
+
+    bool decodeBlock(const std::vector<uint8_t>& raw, std::vector<TransactionNode>& transactions) {
+        const uint8_t* data = raw.data();
+        const uint8_t* end = data + raw.size();
+
+        uint64_t count, accountCount;
+        if (!getVarint(data, end, count) || !getVarint(data, end, accountCount)) {
+            return false;
+        }
+
+        std::vector<std::string> accounts(static_cast<size_t>(std::min<uint64_t>(accountCount, raw.size())));
+        if (accounts.size() != accountCount) {
+            return false;
+        }
+        for (auto& account : accounts) {
+            if (!getString(data, end, account)) {
+                return false;
+            }
+        }
+
+        size_t first = transactions.size();
+        int64_t previousTimestamp = 0;
+        for (uint64_t i = 0; i < count; ++i) {
+            TransactionNode t;
+
+            if (data >= end) {
+                return false;
+            }
+            uint8_t flags = *data++;
+            if (flags & flagBinaryHash) {
+                uint64_t hashValue;
+                if (!getFixed(data, end, hashValue, 8)) {
+                    return false;
+                }
+                t.hash = formatHexHash(hashValue);
+            }
+            else if (!getString(data, end, t.hash)) {
+                return false;
+            }
+            t.isValidated = (flags & flagValidated) != 0;
+
+            uint64_t sender, receiver, delta, parentCount;
+            if (!getString(data, end, t.id) ||
+                !getVarint(data, end, sender) || sender >= accounts.size() ||
+                !getVarint(data, end, receiver) || receiver >= accounts.size() ||
+                !getAmount(data, end, t.amount) ||
+                !getAmount(data, end, t.fee) ||
+                !getVarint(data, end, delta) ||
+                !getVarint(data, end, parentCount)) {
+                return false;
+            }
+            t.senderAcc = accounts[sender];
+            t.receiverAcc = accounts[receiver];
+            previousTimestamp += unzigzag(delta);
+            t.timestamp = static_cast<time_t>(previousTimestamp);
+
+            for (uint64_t p = 0; p < parentCount; ++p) {
+                uint64_t backOffset;
+                if (!getVarint(data, end, backOffset)) {
+                    return false;
+                }
+                if (backOffset == 0) {
+                    std::string parent;
+                    if (!getHash(data, end, parent)) {
+                        return false;
+                    }
+                    t.parentHashes.push_back(parent);
+                }
+                else {
+                    if (backOffset > i) {
+                        return false;
+                    }
+                    t.parentHashes.push_back(transactions[first + static_cast<size_t>(i - backOffset)].hash);
+                }
+            }
+
+            transactions.push_back(std::move(t));
+        }
+
+        return data == end;
+    }
+}
+
+bool ArchiveWriter::open(const std::string& filename) {
+    out.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Error opening file '" << filename << "' for writing archive.\n";
+        return false;
+    }
+    out.write(headerMagic, sizeof(headerMagic));
+    offset = sizeof(headerMagic);
+    rawBytes = 0;
+    compressedBytes = 0;
+    blocks.clear();
+    return static_cast<bool>(out);
+}
+
+bool ArchiveWriter::addBlock(const std::vector<const TransactionNode*>& transactions) {
+    if (transactions.empty()) {
+        return true;
+    }
+
+    std::vector<uint8_t> raw = BlockCodec::encodeBlock(transactions);
+    std::vector<uint8_t> compressed = BlockCodec::compress(raw);
+
+    out.write(reinterpret_cast<const char*>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+    blocks.push_back(BlockEntry{ offset, static_cast<uint32_t>(compressed.size()),
+        static_cast<uint32_t>(raw.size()), static_cast<uint32_t>(transactions.size()) });
+    offset += compressed.size();
+    rawBytes += raw.size();
+    compressedBytes += compressed.size();
+    return static_cast<bool>(out);
+}
+
+bool ArchiveWriter::finish() {
+    std::vector<uint8_t> footer;
+    putFixed(footer, blocks.size(), 4);
+    for (const auto& block : blocks) {
+        putFixed(footer, block.offset, 8);
+        putFixed(footer, block.compressedSize, 4);
+        putFixed(footer, block.rawSize, 4);
+        putFixed(footer, block.transactionCount, 4);
+    }
+    putFixed(footer, offset, 8);
+    footer.insert(footer.end(), footerMagic, footerMagic + sizeof(footerMagic));
+
+    out.write(reinterpret_cast<const char*>(footer.data()), static_cast<std::streamsize>(footer.size()));
+    offset += footer.size();
+    out.close();
+    return !out.fail();
+}
+
+bool ArchiveReader::open(const std::string& name) {
+    filename = name;
+    blocks.clear();
+
+    std::ifstream in(filename, std::ios::in | std::ios::binary);
+    if (!in) {
+        std::cerr << "Error opening file '" << filename << "' for reading archive.\n";
+        return false;
+    }
+
+    char magic[8];
+    in.seekg(0, std::ios::end);
+    std::streamoff fileSize = in.tellg();
+    if (fileSize < 24) {
+        std::cerr << "Archive '" << filename << "' is truncated.\n";
+        return false;
+    }
+
+    in.seekg(0);
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, headerMagic, sizeof(magic)) != 0) {
+        std::cerr << "'" << filename << "' is not a transaction archive.\n";
+        return false;
+    }
+
+    // Trailer: footer offset then end magic
+    uint8_t trailer[16];
+    in.seekg(fileSize - 16);
+    in.read(reinterpret_cast<char*>(trailer), sizeof(trailer));
+    const uint8_t* cursor = trailer;
+    uint64_t footerOffset = 0;
+    if (!in || !getFixed(cursor, trailer + 8, footerOffset, 8) || std::memcmp(trailer + 8, footerMagic, sizeof(footerMagic)) != 0 ||
+        footerOffset < sizeof(headerMagic) || footerOffset > static_cast<uint64_t>(fileSize - 16)) {
+        std::cerr << "Archive '" << filename << "' has a corrupt footer.\n";
+        return false;
+    }
+
+    std::vector<uint8_t> footer(static_cast<size_t>(fileSize - 16 - static_cast<std::streamoff>(footerOffset)));
+    in.seekg(static_cast<std::streamoff>(footerOffset));
+    in.read(reinterpret_cast<char*>(footer.data()), static_cast<std::streamsize>(footer.size()));
+
+    const uint8_t* data = footer.data();
+    const uint8_t* end = data + footer.size();
+    uint64_t count;
+    if (!in || !getFixed(data, end, count, 4) || count * 20 != static_cast<uint64_t>(end - data)) {
+        std::cerr << "Archive '" << filename << "' has a corrupt block index.\n";
+        return false;
+    }
+
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t blockOffset, compressedSize, rawSize, transactionCount;
+        if (!getFixed(data, end, blockOffset, 8) || !getFixed(data, end, compressedSize, 4) ||
+            !getFixed(data, end, rawSize, 4) || !getFixed(data, end, transactionCount, 4)) {
+            std::cerr << "Archive '" << filename << "' has a corrupt block index.\n";
+            blocks.clear();
+            return false;
+        }
+        if (blockOffset < sizeof(headerMagic) || blockOffset + compressedSize > footerOffset) {
+            std::cerr << "Archive '" << filename << "' has a block outside the data region.\n";
+            blocks.clear();
+            return false;
+        }
+        blocks.push_back(BlockEntry{ blockOffset, static_cast<uint32_t>(compressedSize),
+            static_cast<uint32_t>(rawSize), static_cast<uint32_t>(transactionCount) });
+    }
+    return true;
+}
+
+size_t ArchiveReader::transactionCount() const {
+    size_t total = 0;
+    for (const auto& block : blocks) {
+        total += block.transactionCount;
+    }
+    return total;
+}
+
+bool ArchiveReader::readBlock(size_t index, std::vector<TransactionNode>& transactions) const {
+    if (index >= blocks.size()) {
+        return false;
+    }
+    const BlockEntry& block = blocks[index];
+
+    // Each call uses its own stream so blocks can be decoded concurrently
+    std::ifstream in(filename, std::ios::in | std::ios::binary);
+    std::vector<uint8_t> compressed(block.compressedSize);
+    in.seekg(static_cast<std::streamoff>(block.offset));
+    in.read(reinterpret_cast<char*>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+    if (!in) {
+        return false;
+    }
+
+    std::vector<uint8_t> raw;
+    if (!BlockCodec::decompress(compressed.data(), compressed.size(), block.rawSize, raw)) {
+        return false;
+    }
+    return BlockCodec::decodeBlock(raw, transactions);
+}
+
+bool ArchiveReader::readAll(std::vector<TransactionNode>& transactions, unsigned threads) const {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<std::vector<TransactionNode>> decoded(blocks.size());
+    bool ok = true;
+
+    // Decode in waves of 'threads' blocks; block order is preserved in the output
+    for (size_t start = 0; start < blocks.size(); start += threads) {
+        size_t stop = std::min(blocks.size(), start + threads);
+        std::vector<std::future<bool>> pending;
+        for (size_t i = start; i < stop; ++i) {
+            pending.push_back(std::async(std::launch::async, [this, i, &decoded] {
+                return readBlock(i, decoded[i]);
+            }));
+        }
+        for (auto& result : pending) {
+            ok = result.get() && ok;
+        }
+    }
+
+    if (!ok) {
+        std::cerr << "Archive '" << filename << "' contains a corrupt block.\n";
+        return false;
+    }
+
+    transactions.reserve(transactions.size() + transactionCount());
+    for (auto& block : decoded) {
+        std::move(block.begin(), block.end(), std::back_inserter(transactions));
+    }
+    return true;
+}
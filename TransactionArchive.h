@@ -0,0 +1,90 @@
+#ifndef TRANSACTION_ARCHIVE_H
+#define TRANSACTION_ARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "TransactionNode.h"
+
+// Compact binary encoding for transaction history.
+//
+// Transactions are grouped into blocks that decode independently. Inside a
+// block, accounts are dictionary encoded, timestamps are zigzag varint deltas,
+// hex hashes are stored as 8 raw bytes, and a parent that appears earlier in
+// the same block is a varint back-offset instead of a full hash. Each block is
+// then compressed with a small LZ77 codec. A footer indexes every block, so
+// readers can seek straight to one block or decode all of them in parallel.
+namespace BlockCodec {
+    void putVarint(std::vector<uint8_t>& out, uint64_t value);
+    bool getVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value);
+
+    void putString(std::vector<uint8_t>& out, const std::string& value);
+    bool getString(const uint8_t*& data, const uint8_t* end, std::string& value);
+
+    // LZ77 with 64 KiB window; decompress needs the original size
+    std::vector<uint8_t> compress(const std::vector<uint8_t>& input);
+    bool decompress(const uint8_t* data, size_t size, size_t rawSize, std::vector<uint8_t>& output);
+
+    // Transactions should be in topological order so parent back-offsets apply
+    std::vector<uint8_t> encodeBlock(const std::vector<const TransactionNode*>& transactions);
+    bool decodeBlock(const std::vector<uint8_t>& raw, std::vector<TransactionNode>& transactions);
+}
+
+class ArchiveWriter {
+public:
+    bool open(const std::string& filename);
+    bool addBlock(const std::vector<const TransactionNode*>& transactions);
+    bool finish();
+
+    uint64_t bytesWritten() const { return offset; }
+
+    // Encoded block bytes before and after LZ77, summed over the blocks added so far
+    uint64_t rawBlockBytes() const { return rawBytes; }
+    uint64_t compressedBlockBytes() const { return compressedBytes; }
+    double compressionRatio() const {
+        return compressedBytes == 0 ? 0.0 : static_cast<double>(rawBytes) / static_cast<double>(compressedBytes);
+    }
+
+private:
+    struct BlockEntry {
+        uint64_t offset;
+        uint32_t compressedSize;
+        uint32_t rawSize;
+        uint32_t transactionCount;
+    };
+
+    std::ofstream out;
+    uint64_t offset = 0;
+    uint64_t rawBytes = 0;
+    uint64_t compressedBytes = 0;
+    std::vector<BlockEntry> blocks;
+};
+
+class ArchiveReader {
+public:
+    bool open(const std::string& filename);
+
+    size_t blockCount() const { return blocks.size(); }
+    size_t transactionCount() const;
+
+    // Decode a single block without touching the others
+    bool readBlock(size_t index, std::vector<TransactionNode>& transactions) const;
+
+    // Decode every block, spreading the work over up to 'threads' workers
+    bool readAll(std::vector<TransactionNode>& transactions, unsigned threads = 0) const;
+
+private:
+    struct BlockEntry {
+        uint64_t offset;
+        uint32_t compressedSize;
+        uint32_t rawSize;
+        uint32_t transactionCount;
+    };
+
+    std::string filename;
+    std::vector<BlockEntry> blocks;
+};
+
+#endif // TRANSACTION_ARCHIVE_H
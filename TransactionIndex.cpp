@@ -0,0 +1,90 @@
+#include "TransactionIndex.h"
+#include <algorithm>
+#include <utility>
+
+const size_t TransactionCursor::maxReserve;
+
+TransactionCursor::TransactionCursor(TimeIterator begin, TimeIterator end, TransactionResolver resolver)
+    : timeOrdered(true), current(begin), end(end), resolver(std::move(resolver)) {}
+
+TransactionCursor::TransactionCursor(const std::vector<uint32_t>* postings, size_t limit, TransactionResolver resolver)
+    : timeOrdered(false), postings(postings), resolver(std::move(resolver)) {
+    if (postings) {
+        remaining = std::min(limit, postings->size());
+        position = postings->size();
+    }
+}
+
+bool TransactionCursor::hasNext() const {
+    return timeOrdered ? current != end : remaining > 0;
+}
+
+bool TransactionCursor::nextId(uint32_t& id) {
+    if (timeOrdered) {
+        if (current == end) {
+            return false;
+        }
+        id = current->second;
+        ++current;
+        return true;
+    }
+
+    if (remaining == 0) {
+        return false;
+    }
+    // Posting lists are append-only, so positions taken at creation stay valid as they grow
+    id = (*postings)[--position];
+    --remaining;
+    return true;
+}
+
+std::vector<TransactionNode> TransactionCursor::nextPage(size_t pageSize) {
+    std::vector<TransactionNode> page;
+    page.reserve(std::min(pageSize, timeOrdered ? maxReserve : remaining));
+
+    uint32_t id;
+    while (page.size() < pageSize && nextId(id)) {
+        TransactionNode transaction;
+        if (resolver(id, transaction)) {
+            page.push_back(std::move(transaction));
+        }
+    }
+    return page;
+}
+
+void TransactionIndex::add(uint32_t id, const TransactionNode& transaction) {
+    byTime.emplace_hint(byTime.end(), transaction.timestamp, id);
+
+    byAccount[transaction.senderAcc].push_back(id);
+    if (transaction.receiverAcc != transaction.senderAcc) {
+        byAccount[transaction.receiverAcc].push_back(id);
+    }
+}
+
+size_t TransactionIndex::memoryUsage() const {
+    // A tree node carries three pointers and a color besides the payload
+    size_t bytes = byTime.size() * (sizeof(std::pair<const time_t, uint32_t>) + 4 * sizeof(void*));
+    bytes += byAccount.bucket_count() * sizeof(void*);
+    for (const auto& pair : byAccount) {
+        bytes += sizeof(pair) + sizeof(void*) + pair.second.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+void TransactionIndex::clear() {
+    byTime.clear();
+    byAccount.clear();
+}
+
+TransactionCursor TransactionIndex::timeRange(time_t from, time_t to, TransactionResolver resolver) const {
+    if (from > to) {
+        return TransactionCursor(byTime.end(), byTime.end(), std::move(resolver));
+    }
+    return TransactionCursor(byTime.lower_bound(from), byTime.upper_bound(to), std::move(resolver));
+}
+
+TransactionCursor TransactionIndex::account(const std::string& account, size_t limit, TransactionResolver resolver) const {
+    auto it = byAccount.find(account);
+    const std::vector<uint32_t>* postings = (it == byAccount.end()) ? nullptr : &it->second;
+    return TransactionCursor(postings, limit, std::move(resolver));
+}
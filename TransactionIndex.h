@@ -0,0 +1,74 @@
+#ifndef TRANSACTION_INDEX_H
+#define TRANSACTION_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TransactionNode.h"
+
+// Resolves a dense node id to its transaction; returns false if unknown
+using TransactionResolver = std::function<bool(uint32_t, TransactionNode&)>;
+
+// Lazily walks the results of an index query one page at a time, so only the
+// current page is ever materialized. A cursor points into its TransactionIndex:
+// add() leaves it valid (it just does not see the new entries), while clear()
+// or destroying the index leaves it dangling.
+class TransactionCursor {
+public:
+    using TimeIterator = std::multimap<time_t, uint32_t>::const_iterator;
+
+    // Cursor over a time-ordered range [begin, end)
+    TransactionCursor(TimeIterator begin, TimeIterator end, TransactionResolver resolver);
+
+    // Cursor over a posting list, newest entry first, returning at most 'limit' results
+    TransactionCursor(const std::vector<uint32_t>* postings, size_t limit, TransactionResolver resolver);
+
+    bool hasNext() const;
+
+    // Return up to pageSize further results
+    std::vector<TransactionNode> nextPage(size_t pageSize);
+
+private:
+    // Largest up-front reservation for a time range page, whose length is not known
+    static const size_t maxReserve = 1024;
+
+    bool nextId(uint32_t& id);
+
+    bool timeOrdered;
+    TimeIterator current;
+    TimeIterator end;
+    const std::vector<uint32_t>* postings = nullptr;
+    size_t position = 0;   // One past the next posting entry to visit
+    size_t remaining = 0;  // Posting entries left to visit
+    TransactionResolver resolver;
+};
+
+// Secondary indexes over the DAG, maintained as transactions are attached
+class TransactionIndex {
+public:
+    void add(uint32_t id, const TransactionNode& transaction);
+    // Invalidates every cursor handed out so far
+    void clear();
+
+    // Transactions with from <= timestamp <= to, oldest first
+    TransactionCursor timeRange(time_t from, time_t to, TransactionResolver resolver) const;
+
+    // Transactions sent or received by the account, newest first
+    TransactionCursor account(const std::string& account, size_t limit, TransactionResolver resolver) const;
+
+    size_t accountCount() const { return byAccount.size(); }
+
+    // Approximate heap bytes held by both indexes
+    size_t memoryUsage() const;
+
+private:
+    std::multimap<time_t, uint32_t> byTime;
+    std::unordered_map<std::string, std::vector<uint32_t>> byAccount;
+};
+
+#endif // TRANSACTION_INDEX_H
@@ -0,0 +1,475 @@
+#include "TransactionStore.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <queue>
+#include <utility>
+
+namespace {
+    // FNV-1a; stable across runs, unlike std::hash
+    uint64_t hashKey(const std::string& key) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c : key) {
+            hash ^= c;
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    uint64_t cacheKey(uint64_t sequence, size_t block) {
+        return (sequence << 32) | static_cast<uint64_t>(block);
+    }
+
+    size_t transactionBytes(const TransactionNode& transaction) {
+        size_t bytes = sizeof(TransactionNode) + transaction.id.capacity() + transaction.senderAcc.capacity()
+            + transaction.receiverAcc.capacity() + transaction.hash.capacity()
+            + transaction.parentHashes.capacity() * sizeof(std::string);
+        for (const auto& parent : transaction.parentHashes) {
+            bytes += parent.capacity();
+        }
+        return bytes;
+    }
+}
+
+void LsmTransactionStore::BloomFilter::build(const std::vector<std::string>& keys, size_t bitsPerKey) {
+    size_t bitCount = std::max<size_t>(64, keys.size() * bitsPerKey);
+    bits.assign((bitCount + 63) / 64, 0);
+    // k = ln 2 * bits per key minimizes the false positive rate
+    probes = static_cast<uint32_t>(std::min<size_t>(std::max<size_t>(bitsPerKey * 69 / 100, 1), 30));
+
+    const uint64_t totalBits = bits.size() * 64;
+    for (const auto& key : keys) {
+        uint64_t hash = hashKey(key);
+        uint64_t delta = (hash >> 33) | (hash << 31);
+        for (uint32_t i = 0; i < probes; ++i) {
+            uint64_t bit = hash % totalBits;
+            bits[bit / 64] |= 1ULL << (bit % 64);
+            hash += delta;
+        }
+    }
+}
+
+bool LsmTransactionStore::BloomFilter::mayContain(const std::string& key) const {
+    if (bits.empty()) {
+        return false;
+    }
+    const uint64_t totalBits = bits.size() * 64;
+    uint64_t hash = hashKey(key);
+    uint64_t delta = (hash >> 33) | (hash << 31);
+    for (uint32_t i = 0; i < probes; ++i) {
+        uint64_t bit = hash % totalBits;
+        if (!(bits[bit / 64] & (1ULL << (bit % 64)))) {
+            return false;
+        }
+        hash += delta;
+    }
+    return true;
+}
+
+LsmTransactionStore::LsmTransactionStore(const std::string& pathPrefix, const LsmStoreOptions& options)
+    : pathPrefix(pathPrefix), options(options) {
+    this->options.memtableLimit = std::max<size_t>(this->options.memtableLimit, 1);
+    this->options.transactionsPerBlock = std::max<size_t>(this->options.transactionsPerBlock, 1);
+    this->options.tierFanout = std::max<size_t>(this->options.tierFanout, 2);
+}
+
+LsmTransactionStore::~LsmTransactionStore() {
+    removeRuns(0);
+}
+
+void LsmTransactionStore::put(const TransactionNode& transaction) {
+    // Each hash is expected to be stored once; a repeated put replaces the old copy
+    if (memtable.insert_or_assign(transaction.hash, transaction).second) {
+        ++count;
+    }
+    if (memtable.size() >= options.memtableLimit) {
+        flush();
+    }
+}
+
+bool LsmTransactionStore::get(const std::string& hash, TransactionNode& transaction) const {
+    auto buffered = memtable.find(hash);
+    if (buffered != memtable.end()) {
+        transaction = buffered->second;
+        return true;
+    }
+
+    // Newest run first, so the latest copy of a key wins
+    for (auto run = runs.rbegin(); run != runs.rend(); ++run) {
+        const Run& current = **run;
+        if (!current.filter.mayContain(hash)) {
+            continue;
+        }
+        auto next = std::upper_bound(current.firstKeys.begin(), current.firstKeys.end(), hash);
+        if (next == current.firstKeys.begin()) {
+            continue;
+        }
+        size_t index = static_cast<size_t>(next - current.firstKeys.begin()) - 1;
+
+        Block block = readBlock(current, index);
+        if (!block) {
+            continue;
+        }
+        auto found = std::lower_bound(block->begin(), block->end(), hash,
+            [](const TransactionNode& node, const std::string& key) { return node.hash < key; });
+        if (found != block->end() && found->hash == hash) {
+            transaction = *found;
+            return true;
+        }
+    }
+    return false;
+}
+
+LsmTransactionStore::Block LsmTransactionStore::readBlock(const Run& run, size_t index) const {
+    uint64_t key = cacheKey(run.sequence, index);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto cached = cacheEntries.find(key);
+        if (cached != cacheEntries.end()) {
+            cacheOrder.splice(cacheOrder.begin(), cacheOrder, cached->second);
+            ++hits;
+            return cached->second->second;
+        }
+        ++misses;
+    }
+
+    auto decoded = std::make_shared<std::vector<TransactionNode>>();
+    if (!run.reader.readBlock(index, *decoded)) {
+        std::cerr << "Error reading block " << index << " of '" << run.filename << "'.\n";
+        return nullptr;
+    }
+    Block block = decoded;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (options.cacheBlocks > 0 && cacheEntries.find(key) == cacheEntries.end()) {
+        cacheOrder.emplace_front(key, block);
+        cacheEntries[key] = cacheOrder.begin();
+        while (cacheOrder.size() > options.cacheBlocks) {
+            cacheEntries.erase(cacheOrder.back().first);
+            cacheOrder.pop_back();
+        }
+    }
+    return block;
+}
+
+bool LsmTransactionStore::flush() {
+    if (memtable.empty()) {
+        return true;
+    }
+
+    auto position = memtable.begin();
+    std::unique_ptr<Run> run = writeRun([&](TransactionNode& transaction) {
+        if (position == memtable.end()) {
+            return false;
+        }
+        transaction = std::move(position->second);
+        ++position;
+        return true;
+    });
+    memtable.clear();
+    if (!run) {
+        return false;
+    }
+
+    diskBytes += run->bytes;
+    runs.push_back(std::move(run));
+    return compactTiers();
+}
+
+// Tiers only decrease toward the newest run, and no tier holds tierFanout runs
+// once this returns, so a full tier is always the newest tierFanout runs. Merging
+// a contiguous run of ages keeps the runs ordered oldest first.
+bool LsmTransactionStore::compactTiers() {
+    while (runs.size() >= options.tierFanout) {
+        size_t first = runs.size() - options.tierFanout;
+        unsigned tier = runs.back()->tier;
+        bool full = std::all_of(runs.begin() + static_cast<std::ptrdiff_t>(first), runs.end(),
+            [tier](const std::unique_ptr<Run>& run) { return run->tier == tier; });
+        if (!full) {
+            break;
+        }
+        if (!compact(first)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Write transactions arriving in hash order as a new run and open it for reading
+std::unique_ptr<LsmTransactionStore::Run> LsmTransactionStore::writeRun(const std::function<bool(TransactionNode&)>& next) {
+    std::unique_ptr<Run> run(new Run());
+    run->sequence = nextSequence++;
+    run->filename = pathPrefix + ".run" + std::to_string(run->sequence);
+
+    ArchiveWriter writer;
+    if (!writer.open(run->filename)) {
+        return nullptr;
+    }
+
+    std::vector<std::string> keys;
+    std::vector<TransactionNode> block;
+    block.reserve(options.transactionsPerBlock);
+    bool ok = true;
+    auto writeBlock = [&]() {
+        if (block.empty()) {
+            return;
+        }
+        std::vector<const TransactionNode*> pointers;
+        pointers.reserve(block.size());
+        for (const auto& transaction : block) {
+            pointers.push_back(&transaction);
+        }
+        run->firstKeys.push_back(block.front().hash);
+        ok = writer.addBlock(pointers) && ok;
+        block.clear();
+    };
+
+    TransactionNode transaction;
+    while (next(transaction)) {
+        keys.push_back(transaction.hash);
+        block.push_back(std::move(transaction));
+        if (block.size() == options.transactionsPerBlock) {
+            writeBlock();
+        }
+    }
+    writeBlock();
+    ok = writer.finish() && ok;
+
+    if (!ok || !run->reader.open(run->filename)) {
+        std::cerr << "Error writing store run '" << run->filename << "'.\n";
+        std::remove(run->filename.c_str());
+        return nullptr;
+    }
+    run->filter.build(keys, options.bloomBitsPerKey);
+    run->transactionCount = keys.size();
+    run->bytes = writer.bytesWritten();
+    return run;
+}
+
+// Merge runs[first..] into one run of the next tier; duplicates resolve to the newest copy
+bool LsmTransactionStore::compact(size_t first) {
+    struct Cursor {
+        const Run* run;
+        size_t age;  // 0 for the newest run
+        size_t blockIndex;
+        Block block;
+        size_t position;
+    };
+    std::vector<Cursor> cursors;
+    size_t inputCount = 0;
+    uint64_t inputBytes = 0;
+    for (size_t i = first; i < runs.size(); ++i) {
+        cursors.push_back(Cursor{ runs[i].get(), runs.size() - 1 - i, 0, nullptr, 0 });
+        inputCount += runs[i]->transactionCount;
+        inputBytes += runs[i]->bytes;
+    }
+
+    // A block that cannot be read stops the merge: the input runs are then kept,
+    // since deleting them would lose every transaction of that block
+    bool readFailed = false;
+    auto load = [&readFailed](Cursor& cursor) {
+        cursor.position = 0;
+        cursor.block = nullptr;
+        while (!readFailed && cursor.blockIndex < cursor.run->reader.blockCount()) {
+            // Like full scans, compaction bypasses the block cache
+            auto decoded = std::make_shared<std::vector<TransactionNode>>();
+            size_t index = cursor.blockIndex++;
+            if (!cursor.run->reader.readBlock(index, *decoded)) {
+                std::cerr << "Error reading block " << index << " of '" << cursor.run->filename << "'; compaction aborted.\n";
+                readFailed = true;
+                return false;
+            }
+            if (!decoded->empty()) {
+                cursor.block = decoded;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto greater = [&cursors](size_t a, size_t b) {
+        const std::string& left = (*cursors[a].block)[cursors[a].position].hash;
+        const std::string& right = (*cursors[b].block)[cursors[b].position].hash;
+        if (left != right) {
+            return left > right;
+        }
+        return cursors[a].age > cursors[b].age;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        if (load(cursors[i])) {
+            heap.push(i);
+        }
+    }
+
+    std::string lastKey;
+    bool haveLast = false;
+    size_t merged = 0;
+    std::unique_ptr<Run> run = writeRun([&](TransactionNode& transaction) {
+        while (!readFailed && !heap.empty()) {
+            size_t top = heap.top();
+            heap.pop();
+            Cursor& cursor = cursors[top];
+            const TransactionNode& candidate = (*cursor.block)[cursor.position];
+            bool duplicate = haveLast && candidate.hash == lastKey;
+            if (!duplicate) {
+                transaction = candidate;
+                lastKey = candidate.hash;
+                haveLast = true;
+            }
+            if (++cursor.position < cursor.block->size() || load(cursor)) {
+                heap.push(top);
+            }
+            if (!duplicate) {
+                ++merged;
+                return true;
+            }
+        }
+        return false;
+    });
+    if (readFailed) {
+        if (run) {
+            std::string filename = run->filename;
+            run.reset();
+            std::remove(filename.c_str());
+        }
+        return false;
+    }
+    if (!run) {
+        return false;
+    }
+
+    run->tier = runs.back()->tier + 1;
+    removeRuns(first);
+    count -= inputCount - merged;
+    diskBytes = diskBytes - inputBytes + run->bytes;
+    runs.push_back(std::move(run));
+    return true;
+}
+
+void LsmTransactionStore::forEach(const std::function<void(const TransactionNode&)>& visit) const {
+    mergeAll(visit);
+}
+
+// Stream the memtable and every run in hash order, one block per run in memory
+void LsmTransactionStore::mergeAll(const std::function<void(const TransactionNode&)>& visit) const {
+    struct Cursor {
+        size_t runIndex;
+        size_t blockIndex;
+        Block block;
+        size_t position;
+    };
+
+    std::vector<Cursor> cursors;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        cursors.push_back(Cursor{ i, 0, nullptr, 0 });
+    }
+    auto load = [this](Cursor& cursor) {
+        const Run& run = *runs[cursor.runIndex];
+        cursor.position = 0;
+        while (cursor.blockIndex < run.reader.blockCount()) {
+            // Full scans bypass the block cache so they do not evict the hot blocks
+            auto decoded = std::make_shared<std::vector<TransactionNode>>();
+            if (run.reader.readBlock(cursor.blockIndex++, *decoded) && !decoded->empty()) {
+                cursor.block = decoded;
+                return true;
+            }
+        }
+        cursor.block = nullptr;
+        return false;
+    };
+    for (auto& cursor : cursors) {
+        load(cursor);
+    }
+
+    auto buffered = memtable.begin();
+    std::string lastKey;
+    bool haveLast = false;
+    while (true) {
+        // Pick the smallest key; the memtable, then newer runs, win ties
+        const TransactionNode* smallest = nullptr;
+        Cursor* owner = nullptr;
+        if (buffered != memtable.end()) {
+            smallest = &buffered->second;
+        }
+        for (auto cursor = cursors.rbegin(); cursor != cursors.rend(); ++cursor) {
+            if (!cursor->block) {
+                continue;
+            }
+            const TransactionNode& candidate = (*cursor->block)[cursor->position];
+            if (!smallest || candidate.hash < smallest->hash) {
+                smallest = &candidate;
+                owner = &*cursor;
+            }
+        }
+        if (!smallest) {
+            break;
+        }
+
+        if (!haveLast || smallest->hash != lastKey) {
+            visit(*smallest);
+            lastKey = smallest->hash;
+            haveLast = true;
+        }
+
+        if (owner) {
+            if (++owner->position >= owner->block->size()) {
+                load(*owner);
+            }
+        }
+        else {
+            ++buffered;
+        }
+    }
+}
+
+void LsmTransactionStore::clear() {
+    memtable.clear();
+    removeRuns(0);
+    count = 0;
+    diskBytes = 0;
+}
+
+// Delete runs[first..] and drop their cached blocks
+void LsmTransactionStore::removeRuns(size_t first) {
+    std::vector<uint64_t> removed;
+    for (size_t i = first; i < runs.size(); ++i) {
+        std::remove(runs[i]->filename.c_str());
+        removed.push_back(runs[i]->sequence);
+    }
+    runs.resize(std::min(first, runs.size()));
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    for (auto entry = cacheOrder.begin(); entry != cacheOrder.end();) {
+        if (std::find(removed.begin(), removed.end(), entry->first >> 32) != removed.end()) {
+            cacheEntries.erase(entry->first);
+            entry = cacheOrder.erase(entry);
+        }
+        else {
+            ++entry;
+        }
+    }
+}
+
+size_t LsmTransactionStore::memoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& pair : memtable) {
+        // Map node overhead is estimated at four pointers
+        bytes += 4 * sizeof(void*) + sizeof(pair) + pair.first.capacity() + transactionBytes(pair.second);
+    }
+    for (const auto& run : runs) {
+        bytes += sizeof(Run) + run->filter.memoryUsage() + run->reader.blockCount() * 20
+            + run->firstKeys.capacity() * sizeof(std::string);
+        for (const auto& key : run->firstKeys) {
+            bytes += key.capacity();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    for (const auto& entry : cacheOrder) {
+        for (const auto& transaction : *entry.second) {
+            bytes += transactionBytes(transaction);
+        }
+    }
+    return bytes;
+}
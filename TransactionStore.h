@@ -0,0 +1,135 @@
+#ifndef TRANSACTION_STORE_H
+#define TRANSACTION_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TransactionArchive.h"
+#include "TransactionNode.h"
+
+// Backend for transactions that no longer need to stay in memory. The DAG
+// moves frozen history here and falls through to it on lookups that miss the
+// in-memory map.
+class TransactionStore {
+public:
+    virtual ~TransactionStore() = default;
+
+    virtual void put(const TransactionNode& transaction) = 0;
+    virtual bool get(const std::string& hash, TransactionNode& transaction) const = 0;
+
+    // Visit every stored transaction once, in hash order
+    virtual void forEach(const std::function<void(const TransactionNode&)>& visit) const = 0;
+
+    virtual size_t size() const = 0;
+    virtual void clear() = 0;
+
+    // Bytes held in memory by the store itself (buffers, filters, indexes, cache)
+    virtual size_t memoryUsage() const = 0;
+    virtual uint64_t diskUsage() const = 0;
+};
+
+struct LsmStoreOptions {
+    size_t memtableLimit = 4096;    // Transactions buffered before a sorted run is written
+    size_t transactionsPerBlock = 256;
+    size_t bloomBitsPerKey = 10;    // About 1% false positives
+    size_t cacheBlocks = 64;        // Decoded blocks kept in the LRU block cache
+    size_t tierFanout = 4;          // Runs of one tier merged into a single run of the next tier
+};
+
+// Log-structured store: writes collect in a sorted memtable, which is flushed
+// as an immutable sorted run (a transaction archive whose blocks are ordered
+// by hash). Each run keeps its first key per block and a Bloom filter in
+// memory, so a lookup reads at most one block per run whose filter matches,
+// and recently used blocks are served from the block cache.
+//
+// Compaction is size-tiered. A flushed run is tier 0, and once tierFanout runs
+// of one tier have piled up, they are merged into one run of the next tier by
+// a streaming k-way merge that holds one block per run. Each transaction is
+// therefore rewritten once per tier, O(log n) times in all, and there are at
+// most tierFanout - 1 runs per tier. A merge that cannot read one of its input
+// blocks is abandoned and its input runs are kept.
+//
+// Run files are named <pathPrefix>.run<n> and are spill space for the running
+// process; they are deleted by clear() and by the destructor.
+class LsmTransactionStore : public TransactionStore {
+public:
+    explicit LsmTransactionStore(const std::string& pathPrefix, const LsmStoreOptions& options = LsmStoreOptions());
+    ~LsmTransactionStore() override;
+
+    LsmTransactionStore(const LsmTransactionStore&) = delete;
+    LsmTransactionStore& operator=(const LsmTransactionStore&) = delete;
+
+    void put(const TransactionNode& transaction) override;
+    bool get(const std::string& hash, TransactionNode& transaction) const override;
+    void forEach(const std::function<void(const TransactionNode&)>& visit) const override;
+
+    size_t size() const override { return count; }
+    void clear() override;
+
+    size_t memoryUsage() const override;
+    uint64_t diskUsage() const override { return diskBytes; }
+
+    size_t runCount() const { return runs.size(); }
+    uint64_t cacheHits() const { return hits; }
+    uint64_t cacheMisses() const { return misses; }
+
+    // Write the memtable out as a sorted run
+    bool flush();
+
+private:
+    class BloomFilter {
+    public:
+        void build(const std::vector<std::string>& keys, size_t bitsPerKey);
+        bool mayContain(const std::string& key) const;
+        size_t memoryUsage() const { return bits.capacity() * sizeof(uint64_t); }
+
+    private:
+        std::vector<uint64_t> bits;
+        uint32_t probes = 0;
+    };
+
+    struct Run {
+        uint64_t sequence;
+        std::string filename;
+        ArchiveReader reader;
+        std::vector<std::string> firstKeys;  // Smallest hash in each block
+        BloomFilter filter;
+        size_t transactionCount = 0;
+        uint64_t bytes = 0;
+        unsigned tier = 0;
+    };
+
+    using Block = std::shared_ptr<const std::vector<TransactionNode>>;
+
+    std::unique_ptr<Run> writeRun(const std::function<bool(TransactionNode&)>& next);
+    bool compactTiers();
+    bool compact(size_t first);
+    Block readBlock(const Run& run, size_t index) const;
+    void mergeAll(const std::function<void(const TransactionNode&)>& visit) const;
+    void removeRuns(size_t first);
+
+    std::string pathPrefix;
+    LsmStoreOptions options;
+
+    std::map<std::string, TransactionNode> memtable;
+    std::vector<std::unique_ptr<Run>> runs;  // Oldest first
+    uint64_t nextSequence = 0;
+    size_t count = 0;
+    uint64_t diskBytes = 0;
+
+    // LRU block cache keyed by (run sequence, block index)
+    mutable std::mutex cacheMutex;
+    mutable std::list<std::pair<uint64_t, Block>> cacheOrder;  // Most recent first
+    mutable std::unordered_map<uint64_t, std::list<std::pair<uint64_t, Block>>::iterator> cacheEntries;
+    mutable uint64_t hits = 0;
+    mutable uint64_t misses = 0;
+};
+
+#endif // TRANSACTION_STORE_H
@@ -0,0 +1,125 @@
+#include "WeightSketches.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // splitmix64 finalizer, so consecutive ids land on unrelated registers
+    uint64_t mixId(uint64_t id) {
+        uint64_t z = id + 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+}
+
+const unsigned WeightSketches::minPrecision;
+const unsigned WeightSketches::maxPrecision;
+
+WeightSketches::WeightSketches(unsigned precision) {
+    setPrecision(precision);
+}
+
+void WeightSketches::setPrecision(unsigned value) {
+    precision = std::min(std::max(value, minPrecision), maxPrecision);
+    registerCount = static_cast<size_t>(1) << precision;
+    clear();
+}
+
+double WeightSketches::standardError() const {
+    return 1.04 / std::sqrt(static_cast<double>(registerCount));
+}
+
+uint32_t WeightSketches::addNode(const std::vector<uint32_t>& parents) {
+    if (parentOffsets.empty()) {
+        parentOffsets.push_back(0);
+    }
+    uint32_t id = static_cast<uint32_t>(parentOffsets.size() - 1);
+    parentIds.insert(parentIds.end(), parents.begin(), parents.end());
+    parentOffsets.push_back(static_cast<uint32_t>(parentIds.size()));
+
+    // Element of this node: register from the top bits, rank from the leading zeros of the rest
+    uint64_t hash = mixId(id);
+    size_t slot = static_cast<size_t>(hash >> (64 - precision));
+    uint64_t rest = hash << precision;
+    uint8_t rank = 1;
+    while (rank <= 64 - precision && !(rest & (1ULL << 63))) {
+        rest <<= 1;
+        ++rank;
+    }
+
+    registers.resize(registers.size() + registerCount, 0);
+    settled.push_back(0);
+    registers[static_cast<size_t>(id) * registerCount + slot] = rank;
+
+    pending.assign(parents.begin(), parents.end());
+    while (!pending.empty()) {
+        uint32_t node = pending.back();
+        pending.pop_back();
+        if (node >= id || settled[node]) {
+            continue;
+        }
+        uint8_t& current = registers[static_cast<size_t>(node) * registerCount + slot];
+        if (current >= rank) {
+            continue;
+        }
+        current = rank;
+        pending.insert(pending.end(), parentIds.begin() + parentOffsets[node], parentIds.begin() + parentOffsets[node + 1]);
+    }
+    return id;
+}
+
+void WeightSketches::settle(uint32_t node) {
+    if (node < settled.size()) {
+        settled[node] = 1;
+    }
+}
+
+double WeightSketches::estimate(uint32_t node) const {
+    if (node >= size()) {
+        return 0.0;
+    }
+    const uint8_t* sketch = registers.data() + static_cast<size_t>(node) * registerCount;
+    double m = static_cast<double>(registerCount);
+
+    static const std::vector<double> inversePowers = [] {
+        std::vector<double> table(65);
+        for (int rank = 0; rank <= 64; ++rank) {
+            table[rank] = std::ldexp(1.0, -rank);
+        }
+        return table;
+    }();
+
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (size_t i = 0; i < registerCount; ++i) {
+        sum += inversePowers[sketch[i]];
+        zeros += sketch[i] == 0;
+    }
+
+    double alpha;
+    switch (registerCount) {
+    case 16: alpha = 0.673; break;
+    case 32: alpha = 0.697; break;
+    case 64: alpha = 0.709; break;
+    default: alpha = 0.7213 / (1.0 + 1.079 / m); break;
+    }
+    double raw = alpha * m * m / sum;
+
+    // Linear counting is far more accurate while many registers are still empty
+    if (raw <= 2.5 * m && zeros > 0) {
+        return m * std::log(m / static_cast<double>(zeros));
+    }
+    return raw;
+}
+
+size_t WeightSketches::memoryUsage() const {
+    return registers.capacity() + settled.capacity() + (parentOffsets.capacity() + parentIds.capacity() + pending.capacity()) * sizeof(uint32_t);
+}
+
+void WeightSketches::clear() {
+    registers.clear();
+    settled.clear();
+    parentOffsets.clear();
+    parentIds.clear();
+    pending.clear();
+}
@@ -0,0 +1,61 @@
+#ifndef WEIGHT_SKETCHES_H
+#define WEIGHT_SKETCHES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// HyperLogLog estimates of future cone sizes for an append-only DAG.
+//
+// Nodes are identified by dense ids in insertion order, and every node must be
+// added after all of its parents. Each node owns 2^precision one-byte registers
+// describing the set {node} + its future cone. Adding a node inserts its own
+// element into the sketches of its ancestors, walking parent links only while
+// a register actually grows: an approver's sketch never exceeds its parent's
+// register by register, so once a parent already holds the element's rank its
+// whole past cone does too. Most insertions stop after a few levels, so the
+// amortized cost per edge is bounded by the sketch, not by the cone.
+//
+// Settled nodes cut propagation short: once a node is confirmed its ancestors
+// are confirmed too (their sketches already cover its cone), so the work per
+// insertion is bounded by the unconfirmed part of the DAG.
+//
+// The relative standard error is about 1.04 / sqrt(2^precision).
+class WeightSketches {
+public:
+    static const unsigned minPrecision = 4;
+    static const unsigned maxPrecision = 14;
+
+    explicit WeightSketches(unsigned precision = 7);
+
+    // Drops every sketch
+    void setPrecision(unsigned precision);
+    unsigned getPrecision() const { return precision; }
+    double standardError() const;
+
+    // Add the next node and insert it into its ancestors' sketches; returns its id
+    uint32_t addNode(const std::vector<uint32_t>& parents);
+
+    // Stop updating a node whose weight no longer matters (confirmed). Its
+    // estimate freezes, and propagation no longer passes through it.
+    void settle(uint32_t node);
+
+    // Estimated size of the node's future cone, counting the node itself
+    double estimate(uint32_t node) const;
+
+    size_t size() const { return settled.size(); }
+    size_t memoryUsage() const;
+    void clear();
+
+private:
+    unsigned precision;
+    size_t registerCount;
+
+    std::vector<uint8_t> registers;       // node -> registerCount ranks
+    std::vector<uint8_t> settled;         // node -> 1 once it no longer receives elements
+    std::vector<uint32_t> parentOffsets;  // CSR parent lists, node -> [offset, next offset)
+    std::vector<uint32_t> parentIds;
+    std::vector<uint32_t> pending;        // Work list reused across insertions
+};
+
+#endif // WEIGHT_SKETCHES_H
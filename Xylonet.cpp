@@ -6,7 +6,10 @@
 #include <fstream>
 #include <sstream>
 #include <functional>  // For std::hash
+#include <algorithm>
 #include "DAG.h"
+#include "IngestReactor.h"
+#include "Mempool.h"
 
 using namespace std;
 
@@ -16,7 +19,8 @@ void displayMenu() {
     cout << "===================================\n";
     cout << "1. Add Transaction\n";
     cout << "2. View All Transactions and DAG\n";
-    cout << "3. Exit\n";
+    cout << "3. Ingest Transactions from Files\n";
+    cout << "4. Exit\n";
     cout << "===================================\n";
     cout << "Enter your choice: ";
 }
@@ -30,24 +34,6 @@ string generateSimpleHash(const string& transactionDetails) {
     return ss.str();
 }
 
-string formatTimestamp(time_t timestamp) {
-    struct tm timeinfo;
-    char buffer[80];
-
-    if (localtime_s(&timeinfo, &timestamp) != 0) {
-        cerr << "Error: Invalid timestamp provided.\n";
-        return "Invalid Timestamp";
-    }
-
-    if (strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo) == 0) {
-        cerr << "Error: Failed to format timestamp.\n";
-        return "Formatting Error";
-    }
-
-    return string(buffer);
-}
-
-
 bool isValidTransactionId(int id) {
     return id > 0;
 }
@@ -116,80 +102,67 @@ void addTransaction(DAG& dag) {
     }
 }
 
-void saveDAGToFile(const DAG& dag) {
-    ofstream file("dag_transactions.txt");
+void ingestTransactions(DAG& dag, TipSelectionEngine& tipEngine) {
+    string line;
+    cout << "Enter source files or FIFOs (space separated, lines of id,sender,receiver,amount): ";
+    getline(cin >> ws, line);
+
+    // Sources are read concurrently by the reactor; each decoded batch goes
+    // through the mempool so higher-fee transactions attach first, with the
+    // parents of the whole batch chosen by parallel walks
+    Mempool mempool(dag, 100000);
+    mempool.setTipSelectionEngine(&tipEngine);
+    uint64_t rejected = 0;
+    IngestReactor reactor([&](vector<TransactionNode>& batch) {
+        for (auto& transaction : batch) {
+            // Backpressure queues nothing: attach a batch to make room and offer the
+            // transaction again. The reactor, and so every source, waits meanwhile.
+            AdmissionResult result;
+            while ((result = mempool.submit(transaction)) == AdmissionResult::Backpressure) {
+                mempool.attachBatch(batch.size());
+            }
+            if (result == AdmissionResult::Rejected) {
+                ++rejected;
+            }
+        }
+        mempool.attachBatch(batch.size());
+    });
 
-    if (!file) {
-        cerr << "Error opening file for writing.\n";
-        return;
+    stringstream ss(line);
+    string path;
+    while (ss >> path) {
+        reactor.addFile(path);
     }
 
-    file << "Transaction ID | Sender Account | Receiver Account | Amount | Fee | Timestamp | Hash | Parent Hashes\n";
-    file << "------------------------------------------------------------\n";
-
-    // Serialize the transactions and DAG structure to the file
-    for (const auto& pair : dag.getTransactions()) {
-        const auto& t = pair.second;
-
-        // Format the timestamp into a readable string
-        string formattedTimestamp = formatTimestamp(t.timestamp);
-
-        file << t.id << " | " << t.senderAcc << " | " << t.receiverAcc << " | "
-            << t.amount << " | " << t.fee << " | " << formattedTimestamp << " | "
-            << t.hash << " | ";
+    reactor.runUntilDrained();
+    cout << "Ingested " << reactor.decodedCount() << " transactions ("
+        << reactor.malformedCount() << " malformed lines skipped, "
+        << rejected << " rejected by the mempool).\n";
+}
 
-        // Save parent hashes
-        for (const auto& parentHash : t.parentHashes) {
-            file << parentHash << " ";
-        }
-        file << "\n";
-    }
+// The node's state lives in dag_transactions.txt, with the checkpoint (frozen
+// frontier and retired transactions) next to it in dag_transactions.txt.checkpoint,
+// so a restarted node resumes from its latest checkpoint with the stored parents
+const char* const dagFile = "dag_transactions.txt";
 
-    cout << "DAG saved to file successfully.\n";
+void saveDAGToFile(DAG& dag) {
+    dag.saveTransactionsToFile(dagFile);
 }
 
 void loadDAGFromFile(DAG& dag) {
-    ifstream file("dag_transactions.txt");
-    if (!file) {
-        cerr << "Error opening file for reading.\n";
+    if (!dag.loadTransactionsFromFile(dagFile)) {
         return;
     }
-
-    string line;
-
-    getline(file, line);
-
-    getline(file, line);
-
-    while (getline(file, line)) {
-        stringstream ss(line);
-        int id;
-        string sender, receiver, hash, parentHash;
-        double amount, fee;
-        time_t timestamp;
-        vector<string> parentHashes;
-
-        ss >> id >> sender >> receiver >> amount >> fee >> timestamp >> hash;
-
-        while (ss >> parentHash) {
-            parentHashes.push_back(parentHash);
-        }
-
-        cout << "Loaded Transaction ID: " << id << " with parents: ";
-        for (const auto& p : parentHashes) {
-            cout << p << " ";
-        }
-        cout << endl;
-
-        TransactionNode transaction(to_string(id), sender, receiver, amount, fee, timestamp, parentHashes, false);
-        dag.addTransaction(transaction);
-    }
-    cout << "DAG loaded from file successfully.\n";
+    cout << "DAG loaded from file successfully: " << dag.getTransactions().size() + dag.coldTransactionCount()
+        << " transactions, " << dag.checkpointHeight() << " below the checkpoint.\n";
 }
 
 int main() {
     DAG dag;
 
+    // Walk threads are started once and reused by every ingest run
+    TipSelectionEngine tipEngine;
+
     loadDAGFromFile(dag);
 
     double validationThreshold = 1.0;
@@ -209,13 +182,18 @@ int main() {
             dag.printDAG();
             break;
         case 3:
+            ingestTransactions(dag, tipEngine);
+            saveDAGToFile(dag);
+            dag.performConsensus(validationThreshold);
+            break;
+        case 4:
             saveDAGToFile(dag);
             cout << "Exiting the program. Goodbye!\n";
             break;
         default:
             cout << "Invalid choice. Please try again.\n";
         }
-    } while (choice != 3);
+    } while (choice != 4);
 
     return 0;
 }
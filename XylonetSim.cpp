@@ -0,0 +1,135 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "Simulator.h"
+
+using namespace std;
+
+void printUsage() {
+    cout << "Usage: XylonetSim [key=value ...]\n";
+    cout << "  issuers=<n>        Number of virtual issuers\n";
+    cout << "  rate=<tx/s>        Issue rate per issuer\n";
+    cout << "  delay=<seconds>    Mean network delay\n";
+    cout << "  dist=<constant|uniform|exponential>\n";
+    cout << "  parents=<n>        Parents per transaction\n";
+    cout << "  threshold=<w>      Validation threshold\n";
+    cout << "  consensus=<s>      Seconds between consensus passes\n";
+    cout << "  duration=<s>       Simulated seconds\n";
+    cout << "  seed=<n>           Master seed\n";
+    cout << "  entry=<n>          Walks start n levels below the deepest transaction\n";
+    cout << "  maxage=<n>         Unconfirmed transactions n levels below the deepest are lazy\n";
+    cout << "  alpha=<a>          Walk bias toward heavier approvers\n";
+    cout << "  coldstore=<prefix> Spill frozen history to an on-disk store at prefix\n";
+    cout << "  hotwindow=<n>      Frozen transactions kept in memory with a cold store\n";
+    cout << "  weights=<exact|approx>\n";
+    cout << "  precision=<p>      2^p sketch registers per node with weights=approx\n";
+    cout << "  memreport=<s>      Print a DAG memory report every s simulated seconds\n";
+    cout << "  metrics=<s>        Print DAG statistics in Prometheus text format every s simulated seconds\n";
+}
+
+bool applyOption(SimulationConfig& config, const string& key, const string& value) {
+    if (key == "issuers") {
+        config.numIssuers = strtoul(value.c_str(), nullptr, 10);
+    }
+    else if (key == "rate") {
+        config.issueRate = atof(value.c_str());
+    }
+    else if (key == "delay") {
+        config.meanDelay = atof(value.c_str());
+    }
+    else if (key == "dist") {
+        if (value == "constant") {
+            config.delayDistribution = DelayDistribution::Constant;
+        }
+        else if (value == "uniform") {
+            config.delayDistribution = DelayDistribution::Uniform;
+        }
+        else if (value == "exponential") {
+            config.delayDistribution = DelayDistribution::Exponential;
+        }
+        else {
+            return false;
+        }
+    }
+    else if (key == "parents") {
+        config.numParents = strtoul(value.c_str(), nullptr, 10);
+    }
+    else if (key == "threshold") {
+        config.validationThreshold = atof(value.c_str());
+    }
+    else if (key == "consensus") {
+        config.consensusInterval = atof(value.c_str());
+    }
+    else if (key == "duration") {
+        config.duration = atof(value.c_str());
+    }
+    else if (key == "seed") {
+        config.seed = strtoull(value.c_str(), nullptr, 10);
+    }
+    else if (key == "entry") {
+        config.walk.entryDepth = static_cast<uint32_t>(strtoul(value.c_str(), nullptr, 10));
+    }
+    else if (key == "maxage") {
+        config.walk.maxTipAge = static_cast<uint32_t>(strtoul(value.c_str(), nullptr, 10));
+    }
+    else if (key == "alpha") {
+        config.walk.alpha = atof(value.c_str());
+    }
+    else if (key == "coldstore") {
+        config.coldStorePrefix = value;
+    }
+    else if (key == "hotwindow") {
+        config.hotWindow = strtoul(value.c_str(), nullptr, 10);
+    }
+    else if (key == "weights") {
+        if (value == "exact") {
+            config.weightMode = WeightMode::Exact;
+        }
+        else if (value == "approx") {
+            config.weightMode = WeightMode::Approximate;
+        }
+        else {
+            return false;
+        }
+    }
+    else if (key == "precision") {
+        config.sketchPrecision = static_cast<unsigned>(strtoul(value.c_str(), nullptr, 10));
+    }
+    else if (key == "memreport") {
+        config.memoryReportInterval = atof(value.c_str());
+    }
+    else if (key == "metrics") {
+        config.metricsInterval = atof(value.c_str());
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SimulationConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        size_t separator = argument.find('=');
+        if (separator == string::npos ||
+            !applyOption(config, argument.substr(0, separator), argument.substr(separator + 1))) {
+            cerr << "Unknown option: " << argument << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (config.numIssuers == 0 || config.consensusInterval <= 0.0 || config.sampleInterval <= 0.0) {
+        cerr << "Invalid configuration.\n";
+        printUsage();
+        return 1;
+    }
+
+    Simulator simulator(config);
+    SimulationReport report = simulator.run();
+    report.print(cout);
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "AmountColumns.h"
+
+using namespace std;
+
+// Times the AmountKernels over synthetic columns. Build once with
+// XYLONET_ENABLE_AVX2=ON and once without; the results column must match
+// between the two builds.
+namespace {
+    template <typename Kernel>
+    double bestMillis(size_t repeats, Kernel kernel) {
+        double best = 0.0;
+        for (size_t i = 0; i < repeats; ++i) {
+            auto start = chrono::steady_clock::now();
+            kernel();
+            double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            if (i == 0 || elapsed < best) {
+                best = elapsed;
+            }
+        }
+        return best;
+    }
+
+    void report(const char* name, double millis, size_t rows, long long result) {
+        cout << "  " << name << ": " << millis << " ms, "
+             << static_cast<double>(rows) / (millis * 1000.0) << " Mrows/s, result " << result << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t rows = 1000000;
+    size_t repeats = 50;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        size_t equals = arg.find('=');
+        string key = arg.substr(0, equals);
+        string value = equals == string::npos ? "" : arg.substr(equals + 1);
+        if (key == "rows") {
+            rows = strtoul(value.c_str(), nullptr, 10);
+        }
+        else if (key == "repeats") {
+            repeats = strtoul(value.c_str(), nullptr, 10);
+        }
+        else {
+            cout << "Usage: AmountKernelsBench [rows=<n>] [repeats=<n>]\n";
+            return 1;
+        }
+    }
+    repeats = repeats == 0 ? 1 : repeats;
+
+    mt19937_64 rng(42);
+    uniform_int_distribution<int64_t> amountDistribution(0, 2000 * AmountColumns::scale);
+    vector<int64_t> amounts(rows);
+    vector<int64_t> timestamps(rows);
+    int64_t timestamp = 1700000000;
+    for (size_t i = 0; i < rows; ++i) {
+        amounts[i] = amountDistribution(rng);
+        timestamp += static_cast<int64_t>(rng() % 3);
+        timestamps[i] = timestamp;
+    }
+    int64_t from = timestamps[rows / 4];
+    int64_t to = timestamps[rows - 1 - rows / 4];
+    int64_t threshold = 1500 * AmountColumns::scale;
+
+    cout << "AmountKernels, " << (AmountKernels::vectorized() ? "AVX2" : "scalar") << " build, "
+         << rows << " rows, best of " << repeats << "\n";
+
+    volatile int64_t sink = 0;
+    // Each result is read only after its kernel has run
+    int64_t total = 0;
+    double millis = bestMillis(repeats, [&] { total = AmountKernels::sum(amounts.data(), rows); sink = total; });
+    report("sum", millis, rows, total);
+
+    int64_t windowed = 0;
+    millis = bestMillis(repeats, [&] {
+        windowed = AmountKernels::sumInWindow(amounts.data(), timestamps.data(), rows, from, to);
+        sink = windowed;
+    });
+    report("sumInWindow", millis, rows, windowed);
+
+    size_t counted = 0;
+    millis = bestMillis(repeats, [&] {
+        counted = AmountKernels::countAtLeast(amounts.data(), rows, threshold);
+        sink = static_cast<int64_t>(counted);
+    });
+    report("countAtLeast", millis, rows, static_cast<long long>(counted));
+
+    vector<uint32_t> selected;
+    selected.reserve(rows);
+    millis = bestMillis(repeats, [&] {
+        selected.clear();
+        AmountKernels::filterAtLeast(amounts.data(), rows, threshold, selected);
+        sink = static_cast<int64_t>(selected.size());
+    });
+    long long rowSum = 0;
+    for (uint32_t row : selected) {
+        rowSum += row;
+    }
+    report("filterAtLeast (sum of rows)", millis, rows, rowSum);
+
+    (void)sink;
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "AmountColumns.h"
+#include "TestSupport.h"
+
+// Built twice: against the library's kernels, and (where the compiler can
+// target it) with AmountColumns.cpp compiled for AVX2, so both variants are
+// checked against the plain loops below in every build.
+namespace {
+    int64_t plainSum(const int64_t* values, size_t count) {
+        int64_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            total += values[i];
+        }
+        return total;
+    }
+
+    int64_t plainSumInWindow(const int64_t* values, const int64_t* timestamps, size_t count, int64_t from, int64_t to) {
+        int64_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (timestamps[i] >= from && timestamps[i] <= to) {
+                total += values[i];
+            }
+        }
+        return total;
+    }
+
+    size_t plainCountAtLeast(const int64_t* values, size_t count, int64_t threshold) {
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (values[i] >= threshold) {
+                ++total;
+            }
+        }
+        return total;
+    }
+
+    // Every length up to a few vectors, at every offset within a vector, so each
+    // combination of full lanes and tail lanes runs; values straddle zero
+    void checkKernels() {
+        std::mt19937_64 rng(17);
+        std::vector<int64_t> values(300);
+        std::vector<int64_t> timestamps(values.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = static_cast<int64_t>(rng() % 2000001) - 1000000;
+            timestamps[i] = 1700000000 + static_cast<int64_t>(rng() % 100);
+        }
+        values[3] = INT64_MIN / 4;
+        values[4] = INT64_MAX / 4;
+
+        const int64_t thresholds[] = { INT64_MIN, -1000000, -1, 0, 1, 999999, INT64_MAX };
+        const int64_t windows[][2] = { { 1700000020, 1700000060 }, { 1700000050, 1700000050 }, { 1700000060, 1700000020 }, { INT64_MIN, INT64_MAX } };
+        for (size_t offset = 0; offset < 4; ++offset) {
+            std::vector<size_t> counts;
+            for (size_t count = 0; count <= 40; ++count) {
+                counts.push_back(count);
+            }
+            counts.push_back(values.size() - offset);
+
+            for (size_t count : counts) {
+                const int64_t* v = values.data() + offset;
+                const int64_t* t = timestamps.data() + offset;
+                CHECK(AmountKernels::sum(v, count) == plainSum(v, count));
+                for (const auto& window : windows) {
+                    CHECK(AmountKernels::sumInWindow(v, t, count, window[0], window[1]) == plainSumInWindow(v, t, count, window[0], window[1]));
+                }
+                for (int64_t threshold : thresholds) {
+                    CHECK(AmountKernels::countAtLeast(v, count, threshold) == plainCountAtLeast(v, count, threshold));
+
+                    // Rows are appended after whatever the vector already holds
+                    std::vector<uint32_t> rows{ 7, 8 };
+                    AmountKernels::filterAtLeast(v, count, threshold, rows);
+                    std::vector<uint32_t> expected{ 7, 8 };
+                    for (size_t i = 0; i < count; ++i) {
+                        if (v[i] >= threshold) {
+                            expected.push_back(static_cast<uint32_t>(i));
+                        }
+                    }
+                    CHECK(rows == expected);
+                }
+            }
+        }
+    }
+}
+
+int main() {
+#if defined(XYLONET_EXPECT_AVX2)
+#if defined(__GNUC__) || defined(__clang__)
+    if (!__builtin_cpu_supports("avx2")) {
+        std::cout << "Skipped: this CPU does not support AVX2.\n";
+        return 77;
+    }
+#endif
+    CHECK(AmountKernels::vectorized());
+#endif
+    checkKernels();
+    return testResult();
+}
@@ -0,0 +1,166 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "HashUtils.h"
+#include "TestSupport.h"
+#include "TransactionArchive.h"
+
+namespace {
+    bool sameTransaction(const TransactionNode& a, const TransactionNode& b) {
+        return a.id == b.id && a.senderAcc == b.senderAcc && a.receiverAcc == b.receiverAcc &&
+            a.amount == b.amount && a.fee == b.fee && a.timestamp == b.timestamp && a.hash == b.hash &&
+            a.parentHashes == b.parentHashes && a.isValidated == b.isValidated;
+    }
+
+    // Topologically ordered history with recent parents, a few unknown ones and some odd values
+    std::vector<TransactionNode> makeHistory(size_t count, uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::vector<TransactionNode> history;
+        for (size_t i = 0; i < count; ++i) {
+            TransactionNode t;
+            t.id = std::to_string(i);
+            t.senderAcc = "account" + std::to_string(rng() % 20);
+            t.receiverAcc = "account" + std::to_string(rng() % 20);
+            t.amount = static_cast<double>(rng() % 200000) / 100.0;
+            t.fee = i % 7 == 0 ? 1.0 / 3.0 : t.amount * 0.01;  // Not representable in millionths
+            t.timestamp = static_cast<time_t>(1700000000 + i * 2 - (rng() % 5));
+            t.hash = i % 50 == 0 ? "not-hex-" + t.id : generateHash(t.id);
+            t.isValidated = rng() % 2 == 0;
+            for (size_t p = 0; p < 3 && i > 0; ++p) {
+                t.parentHashes.push_back(rng() % 10 == 0 ? generateHash("outside" + t.id) : history[i - 1 - rng() % std::min<size_t>(i, 30)].hash);
+            }
+            history.push_back(t);
+        }
+        return history;
+    }
+
+    void checkVarints() {
+        const uint64_t values[] = { 0, 1, 127, 128, 16383, 16384, UINT32_MAX, UINT64_MAX };
+        std::vector<uint8_t> encoded;
+        for (uint64_t value : values) {
+            BlockCodec::putVarint(encoded, value);
+        }
+        BlockCodec::putString(encoded, "");
+        BlockCodec::putString(encoded, "payload");
+
+        const uint8_t* data = encoded.data();
+        const uint8_t* end = data + encoded.size();
+        for (uint64_t value : values) {
+            uint64_t decoded = 0;
+            CHECK(BlockCodec::getVarint(data, end, decoded));
+            CHECK(decoded == value);
+        }
+        std::string text = "x";
+        CHECK(BlockCodec::getString(data, end, text) && text.empty());
+        CHECK(BlockCodec::getString(data, end, text) && text == "payload");
+        CHECK(data == end);
+
+        // A varint cut short is an error, not a short value
+        std::vector<uint8_t> truncated;
+        BlockCodec::putVarint(truncated, UINT64_MAX);
+        truncated.pop_back();
+        data = truncated.data();
+        uint64_t ignored;
+        CHECK(!BlockCodec::getVarint(data, truncated.data() + truncated.size(), ignored));
+    }
+
+    void checkCompression() {
+        std::mt19937_64 rng(5);
+        std::vector<std::vector<uint8_t>> inputs(4);
+        for (size_t i = 0; i < 100000; ++i) {
+            inputs[1].push_back(static_cast<uint8_t>(rng()));          // Incompressible
+            inputs[2].push_back(static_cast<uint8_t>("abcabcab"[i % 8])); // Long matches
+            inputs[3].push_back(static_cast<uint8_t>(rng() % 4));       // Short matches and literals
+        }
+        for (const auto& input : inputs) {
+            std::vector<uint8_t> compressed = BlockCodec::compress(input);
+            std::vector<uint8_t> output;
+            CHECK(BlockCodec::decompress(compressed.data(), compressed.size(), input.size(), output));
+            CHECK(output == input);
+            if (!input.empty()) {
+                CHECK(!BlockCodec::decompress(compressed.data(), compressed.size(), input.size() + 1, output));
+            }
+        }
+        CHECK(BlockCodec::compress(inputs[2]).size() < inputs[2].size() / 20);
+    }
+
+    void checkBlocks() {
+        std::vector<TransactionNode> history = makeHistory(500, 9);
+        std::vector<const TransactionNode*> pointers;
+        for (const auto& t : history) {
+            pointers.push_back(&t);
+        }
+        std::vector<uint8_t> raw = BlockCodec::encodeBlock(pointers);
+        std::vector<TransactionNode> decoded;
+        CHECK(BlockCodec::decodeBlock(raw, decoded));
+        CHECK(decoded.size() == history.size());
+        for (size_t i = 0; i < decoded.size() && i < history.size(); ++i) {
+            CHECK(sameTransaction(decoded[i], history[i]));
+        }
+
+        raw.pop_back();
+        decoded.clear();
+        CHECK(!BlockCodec::decodeBlock(raw, decoded));
+    }
+
+    void checkArchive() {
+        const std::string filename = "BlockCodecTest.archive";
+        std::vector<TransactionNode> history = makeHistory(1000, 13);
+
+        ArchiveWriter writer;
+        CHECK(writer.open(filename));
+        for (size_t start = 0; start < history.size(); start += 128) {
+            std::vector<const TransactionNode*> block;
+            for (size_t i = start; i < std::min(start + 128, history.size()); ++i) {
+                block.push_back(&history[i]);
+            }
+            CHECK(writer.addBlock(block));
+        }
+        CHECK(writer.finish());
+        CHECK(writer.compressionRatio() > 1.0);
+
+        ArchiveReader reader;
+        CHECK(reader.open(filename));
+        CHECK(reader.blockCount() == 8);
+        CHECK(reader.transactionCount() == history.size());
+        std::vector<TransactionNode> loaded;
+        CHECK(reader.readAll(loaded, 4));
+        CHECK(loaded.size() == history.size());
+        for (size_t i = 0; i < loaded.size() && i < history.size(); ++i) {
+            CHECK(sameTransaction(loaded[i], history[i]));
+        }
+
+        std::vector<TransactionNode> single;
+        CHECK(reader.readBlock(7, single));
+        CHECK(single.size() == history.size() - 7 * 128 && sameTransaction(single[0], history[7 * 128]));
+
+        // Damage the block index count; open must fail instead of reading past the footer
+        {
+            std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekg(-16, std::ios::end);
+            uint8_t offsetBytes[8];
+            file.read(reinterpret_cast<char*>(offsetBytes), sizeof(offsetBytes));
+            uint64_t footerOffset = 0;
+            for (int i = 7; i >= 0; --i) {
+                footerOffset = (footerOffset << 8) | offsetBytes[i];
+            }
+            file.seekp(static_cast<std::streamoff>(footerOffset));
+            const char badCount[4] = { 9, 0, 0, 0 };
+            file.write(badCount, sizeof(badCount));
+        }
+        ArchiveReader damaged;
+        CHECK(!damaged.open(filename));
+        std::remove(filename.c_str());
+    }
+}
+
+int main() {
+    checkVarints();
+    checkCompression();
+    checkBlocks();
+    checkArchive();
+    return testResult();
+}
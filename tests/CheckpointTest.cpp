@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "DAG.h"
+#include "TestSupport.h"
+
+namespace {
+    TransactionNode makeTransaction(const std::string& id, const std::vector<std::string>& parents) {
+        TransactionNode transaction(id, "alice", "bob", 10.0, 0.1, 1700000000, parents, false);
+        transaction.hash = generateHash(id);
+        return transaction;
+    }
+
+    // A genesis, one tip left behind by a chain of ten, and consensus that confirms the deep part
+    void buildDAG(DAG& dag) {
+        dag.setVerbose(false);
+        WalkConfig config;
+        config.maxTipAge = 2;
+        dag.setWalkConfig(config);
+
+        TransactionNode genesis = makeTransaction("genesis", {});
+        CHECK(dag.attachTransaction(genesis));
+        TransactionNode lazy = makeTransaction("lazy", { genesis.hash });
+        CHECK(dag.attachTransaction(lazy));
+        std::string previous = genesis.hash;
+        for (int i = 0; i < 10; ++i) {
+            TransactionNode next = makeTransaction("chain" + std::to_string(i), { previous });
+            CHECK(dag.attachTransaction(next));
+            previous = next.hash;
+        }
+        dag.performConsensus(5.0);
+    }
+
+    // Frozen and retired transactions come back as they were saved
+    void checkRoundTrip() {
+        const std::string filename = "CheckpointTest.txt";
+        std::string lazy = generateHash("lazy");
+
+        DAG original;
+        buildDAG(original);
+        CHECK(original.isRetired(lazy));
+        CHECK(original.checkpointHeight() > 0);
+        CHECK(original.getStatistics().orphanCount() == 1);
+        original.saveTransactionsToFile(filename);
+
+        DAG restored;
+        restored.setVerbose(false);
+        CHECK(restored.loadTransactionsFromFile(filename));
+        CHECK(restored.isRetired(lazy));
+        CHECK(!restored.isConfirmed(lazy));
+        CHECK(restored.checkpointHeight() == original.checkpointHeight());
+        CHECK(restored.getCheckpointFrontier() == original.getCheckpointFrontier());
+        CHECK(restored.getStatistics().orphanCount() == 1);
+        const std::vector<std::string>& tips = restored.getTips();
+        CHECK(std::find(tips.begin(), tips.end(), lazy) == tips.end());
+        CHECK(tips == original.getTips());
+
+        std::remove(filename.c_str());
+        std::remove((filename + ".checkpoint").c_str());
+    }
+}
+
+int main() {
+    checkRoundTrip();
+    return testResult();
+}
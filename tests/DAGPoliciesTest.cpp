@@ -0,0 +1,59 @@
+#include <ctime>
+#include <string>
+#include <vector>
+#include "DAG.h"
+#include "TestSupport.h"
+
+namespace {
+    struct FlatFeePolicy {
+        static double calculate(double) { return 2.0; }
+    };
+
+    // A bundle DAG.cpp does not instantiate; it is built from DAG.tpp right here
+    struct TwoParentPolicies {
+        using TipSelector = DepthBoundedWalkTipSelector;
+        using WeightPolicy = ApproverSumWeight;
+        using FeePolicy = FlatFeePolicy;
+        static constexpr size_t numParents = 2;
+    };
+}
+
+int main() {
+    using TwoParentDAG = BasicDAG<TwoParentPolicies>;
+    static_assert(TwoParentDAG::parentCount() == 2, "parent count comes from the bundle");
+    static_assert(DAG::parentCount() == 3, "the default bundle is unchanged");
+
+    TwoParentDAG dag;
+    dag.seedRandom(3);
+    time_t now = std::time(nullptr);
+    for (int i = 0; i < 200; ++i) {
+        TransactionNode transaction(std::to_string(i), "alice", "bob", 10.0 + i, 0, now + i, {}, false);
+        CHECK(dag.addTransaction(transaction));
+        CHECK(transaction.fee == 2.0);
+        CHECK(transaction.parentHashes.size() <= 2);
+        if (i > 0) {
+            CHECK(!transaction.parentHashes.empty());
+        }
+    }
+    CHECK(dag.getTransactions().size() == 200);
+    CHECK(!dag.getTips().empty());
+
+    // Unknown or self parents are rejected before anything is recorded
+    dag.setVerbose(false);
+    std::vector<std::string> tips = dag.getTips();
+    TransactionNode orphan("orphan", "alice", "bob", 1.0, 2.0, now + 500, { tips.front(), generateHash("unknown") }, false);
+    CHECK(!dag.attachTransaction(orphan));
+    TransactionNode self("self", "alice", "bob", 1.0, 2.0, now + 501, {}, false);
+    self.parentHashes = { tips.front(), self.hash };
+    CHECK(!dag.attachTransaction(self));
+    CHECK(dag.getTransactions().size() == 200);
+    CHECK(dag.getTips() == tips);
+    CHECK(dag.depthOf(orphan.hash) == 0 && dag.depthOf(self.hash) == 0);
+    CHECK(dag.getReachabilityIndex().size() == 200);
+
+    TransactionNode child("child", "alice", "bob", 1.0, 2.0, now + 502, { tips.front() }, false);
+    CHECK(dag.attachTransaction(child));
+    CHECK(dag.approves(child.hash, tips.front()));
+    CHECK(!dag.attachTransaction(child));
+    return testResult();
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "DAG.h"
+#include "TestSupport.h"
+
+namespace {
+    bool near(double a, double b) {
+        return std::fabs(a - b) <= 1e-6 * std::max(1.0, std::fabs(b));
+    }
+
+    // Histogram contents recounted from scratch, in the same buckets
+    StatHistogram recount(const StatHistogram& like, const std::vector<double>& values) {
+        StatHistogram histogram(like.bounds());
+        for (double value : values) {
+            histogram.observe(value);
+        }
+        return histogram;
+    }
+
+    bool sameHistogram(const StatHistogram& a, const StatHistogram& b) {
+        return a.count() == b.count() && a.bucketCounts() == b.bucketCounts() && near(a.sum(), b.sum());
+    }
+
+    // Compare every incremental figure with a brute-force recount over the DAG
+    void checkAgainstRecount(const DAG& dag, const std::vector<std::string>& attached,
+        const std::vector<double>& confirmationTimes) {
+        const DAGStatistics& statistics = dag.getStatistics();
+        const uint32_t maxTipAge = dag.getWalkConfig().maxTipAge;
+
+        std::unordered_map<uint32_t, size_t> levelWidths;
+        uint32_t deepest = 0;
+        size_t confirmed = 0;
+        size_t orphans = 0;
+        std::vector<double> parentAges;
+        std::vector<double> approvers;
+        TransactionNode transaction;
+        TransactionNode parent;
+        for (const auto& hash : attached) {
+            uint32_t depth = dag.depthOf(hash);
+            ++levelWidths[depth];
+            deepest = std::max(deepest, depth);
+            confirmed += dag.isConfirmed(hash);
+            orphans += dag.isRetired(hash);
+            approvers.push_back(static_cast<double>(dag.getApprovers(hash).size()));
+            CHECK(dag.getTransaction(hash, transaction));
+            for (const auto& parentHash : transaction.parentHashes) {
+                CHECK(dag.getTransaction(parentHash, parent));
+                parentAges.push_back(static_cast<double>(std::max<int64_t>(transaction.timestamp - parent.timestamp, 0)));
+            }
+        }
+
+        size_t lazyTips = 0;
+        for (const auto& tip : dag.getTips()) {
+            lazyTips += !dag.isConfirmed(tip) && dag.depthOf(tip) + maxTipAge < deepest;
+        }
+        size_t maxWidth = 0;
+        for (const auto& level : levelWidths) {
+            maxWidth = std::max(maxWidth, level.second);
+        }
+
+        CHECK(statistics.nodeCount() == attached.size());
+        CHECK(statistics.tipCount() == dag.tipCount());
+        CHECK(statistics.lazyTipCount() == lazyTips);
+        CHECK(statistics.confirmedCount() == confirmed);
+        CHECK(statistics.orphanCount() == orphans);
+        CHECK(statistics.depth() == deepest);
+        CHECK(statistics.width() == levelWidths[deepest]);
+        CHECK(statistics.maxWidth() == maxWidth);
+        CHECK(near(statistics.meanWidth(), static_cast<double>(attached.size()) / static_cast<double>(deepest + 1)));
+        CHECK(sameHistogram(statistics.parentAges(), recount(statistics.parentAges(), parentAges)));
+        CHECK(sameHistogram(statistics.approversPerNode(), recount(statistics.approversPerNode(), approvers)));
+        CHECK(sameHistogram(statistics.confirmationTimes(), recount(statistics.confirmationTimes(), confirmationTimes)));
+    }
+
+    // Random traffic with side branches that turn lazy and get retired, checked after every pass
+    void checkRandomRun(uint64_t seed) {
+        DAG dag;
+        dag.setVerbose(false);
+        dag.seedRandom(seed);
+        WalkConfig config;
+        config.maxTipAge = 4;
+        config.entryDepth = 3;
+        dag.setWalkConfig(config);
+
+        std::mt19937_64 rng(seed);
+        std::vector<std::string> attached;
+        std::unordered_map<std::string, int64_t> timestamps;
+        std::vector<std::string> unconfirmed;
+        std::vector<double> confirmationTimes;
+        int64_t clock = 1700000000;
+        int64_t newest = 0;
+
+        for (size_t step = 0; step < 600; ++step) {
+            clock += static_cast<int64_t>(rng() % 3);
+            // Some transactions arrive with an older timestamp than the newest one seen
+            time_t timestamp = static_cast<time_t>(clock - static_cast<int64_t>(rng() % 4));
+            TransactionNode transaction(std::to_string(step), "alice", "bob", 10.0, 0.1, timestamp, {}, false);
+            if (rng() % 5 == 0 && !attached.empty()) {
+                // A side branch off a recent transaction; it may be left behind
+                transaction.parentHashes.push_back(attached[attached.size() - 1 - rng() % std::min<size_t>(attached.size(), 12)]);
+            }
+            else {
+                transaction.parentHashes = dag.selectParentsMCMC(DAG::parentCount());
+            }
+            if (dag.attachTransaction(transaction)) {
+                attached.push_back(transaction.hash);
+                timestamps[transaction.hash] = transaction.timestamp;
+                unconfirmed.push_back(transaction.hash);
+                newest = std::max<int64_t>(newest, transaction.timestamp);
+            }
+
+            if (step % 25 == 24) {
+                // An occasional low threshold confirms tips too, including lazy ones
+                dag.performConsensus(step % 100 == 99 ? 1.0 : 4.0);
+                // Time to confirmation is measured against the newest timestamp at the pass
+                for (auto it = unconfirmed.begin(); it != unconfirmed.end();) {
+                    if (dag.isConfirmed(*it)) {
+                        confirmationTimes.push_back(static_cast<double>(std::max<int64_t>(newest - timestamps[*it], 0)));
+                        it = unconfirmed.erase(it);
+                    }
+                    else {
+                        ++it;
+                    }
+                }
+                checkAgainstRecount(dag, attached, confirmationTimes);
+            }
+        }
+        CHECK(dag.getStatistics().confirmedCount() > 0);
+        CHECK(dag.getStatistics().orphanCount() > 0);
+    }
+}
+
+int main() {
+    for (uint64_t seed : { 1u, 2u, 3u }) {
+        checkRandomRun(seed);
+    }
+    return testResult();
+}
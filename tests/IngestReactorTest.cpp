@@ -0,0 +1,149 @@
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "IngestReactor.h"
+#include "TestSupport.h"
+
+namespace {
+    void writeAll(int fd, const std::string& text) {
+        size_t written = 0;
+        while (written < text.size()) {
+            ssize_t count = ::write(fd, text.data() + written, text.size() - written);
+            if (count <= 0) {
+                return;
+            }
+            written += static_cast<size_t>(count);
+        }
+    }
+
+    int listenTcp(uint16_t& port) {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, 4) != 0 ||
+            ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        // The test accepts between reactor turns, so accept must not wait either
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        port = ntohs(address.sin_port);
+        return fd;
+    }
+
+    // A source that never sends must not hold back one that does
+    void checkSlowSourceDoesNotStall() {
+        std::vector<std::string> ids;
+        IngestReactor reactor([&](std::vector<TransactionNode>& batch) {
+            for (const auto& transaction : batch) {
+                ids.push_back(transaction.id);
+            }
+        }, 2);
+
+        int slow[2];
+        int fast[2];
+        CHECK(::pipe(slow) == 0 && ::pipe(fast) == 0);
+        CHECK(reactor.addDescriptor(slow[0], "slow"));
+        CHECK(reactor.addDescriptor(fast[0], "fast"));
+
+        // Lines split across writes are reassembled; malformed lines are counted
+        writeAll(fast[1], "1,alice,bob,10\n2,alice,b");
+        for (int turn = 0; turn < 5; ++turn) {
+            reactor.pollOnce(10);
+        }
+        CHECK(ids.size() == 1);
+        writeAll(fast[1], "ob,20,1700000000\nbroken line\n3,carol,dave,5");
+        ::close(fast[1]);
+        for (int turn = 0; turn < 10 && reactor.activeSources() > 1; ++turn) {
+            reactor.pollOnce(10);
+        }
+        CHECK(reactor.activeSources() == 1);
+        CHECK(ids == std::vector<std::string>({ "1", "2", "3" }));
+        CHECK(reactor.malformedCount() == 1);
+
+        ::close(slow[1]);
+        reactor.runUntilDrained(10);
+        CHECK(reactor.activeSources() == 0);
+        CHECK(reactor.decodedCount() == 3);
+    }
+
+    void checkTcp() {
+        uint16_t port = 0;
+        int listener = listenTcp(port);
+        CHECK(listener >= 0);
+
+        size_t received = 0;
+        IngestReactor reactor([&](std::vector<TransactionNode>& batch) { received += batch.size(); });
+        CHECK(reactor.connectTcp("127.0.0.1", port));
+        CHECK(reactor.connectTcp("localhost", port));
+
+        // Connecting and resolving happen inside the turns, not in connectTcp
+        for (int turn = 0; turn < 50 && reactor.decodedCount() == 0; ++turn) {
+            reactor.pollOnce(10);
+            int peer = ::accept(listener, nullptr, nullptr);
+            if (peer >= 0) {
+                writeAll(peer, "7,erin,frank,1.5\n");
+                ::close(peer);
+            }
+        }
+        for (int turn = 0; turn < 50 && reactor.activeSources() > 0; ++turn) {
+            reactor.pollOnce(10);
+            int peer = ::accept(listener, nullptr, nullptr);
+            if (peer >= 0) {
+                writeAll(peer, "8,erin,frank,2.5\n");
+                ::close(peer);
+            }
+        }
+        CHECK(reactor.activeSources() == 0);
+        CHECK(received == 2);
+        ::close(listener);
+
+        // Nobody listens on the port any more: the source ends with an error instead of blocking
+        IngestReactor refused([](std::vector<TransactionNode>&) {});
+        CHECK(refused.connectTcp("127.0.0.1", port));
+        refused.runUntilDrained(10);
+        CHECK(refused.decodedCount() == 0);
+    }
+
+    void checkUnix() {
+        std::string path = "/tmp/IngestReactorTest." + std::to_string(::getpid()) + ".sock";
+        ::unlink(path.c_str());
+        int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size());
+        CHECK(::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+        CHECK(::listen(listener, 4) == 0);
+
+        size_t received = 0;
+        IngestReactor reactor([&](std::vector<TransactionNode>& batch) { received += batch.size(); });
+        CHECK(reactor.connectUnix(path));
+        reactor.pollOnce(10);
+        int peer = ::accept(listener, nullptr, nullptr);
+        CHECK(peer >= 0);
+        writeAll(peer, "9,gina,hank,3\n10,gina,hank,4\n");
+        ::close(peer);
+        reactor.runUntilDrained(10);
+        CHECK(received == 2);
+
+        ::close(listener);
+        ::unlink(path.c_str());
+    }
+}
+
+int main() {
+    checkSlowSourceDoesNotStall();
+    checkTcp();
+    checkUnix();
+    return testResult();
+}
@@ -0,0 +1,132 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "HashUtils.h"
+#include "TestSupport.h"
+#include "TransactionStore.h"
+
+namespace {
+    const std::string prefix = "LsmStoreTest";
+
+    TransactionNode makeTransaction(size_t i, double amount) {
+        TransactionNode t;
+        t.id = std::to_string(i);
+        t.senderAcc = "account" + std::to_string(i % 20);
+        t.receiverAcc = "account" + std::to_string((i + 1) % 20);
+        t.amount = amount;
+        t.fee = 0.5;
+        t.timestamp = static_cast<time_t>(1700000000 + i);
+        t.hash = generateHash(t.id);
+        return t;
+    }
+
+    // Run files currently on disk; sequence numbers are handed out from 0
+    size_t runFilesOnDisk(size_t maxSequence) {
+        size_t files = 0;
+        for (size_t sequence = 0; sequence < maxSequence; ++sequence) {
+            if (std::ifstream(prefix + ".run" + std::to_string(sequence))) {
+                ++files;
+            }
+        }
+        return files;
+    }
+
+    void checkStore() {
+        LsmStoreOptions options;
+        options.memtableLimit = 16;
+        options.transactionsPerBlock = 4;
+        options.cacheBlocks = 4;
+        options.tierFanout = 3;
+        LsmTransactionStore store(prefix, options);
+
+        const size_t total = 1000;
+        for (size_t i = 0; i < total; ++i) {
+            store.put(makeTransaction(i, static_cast<double>(i)));
+        }
+        CHECK(store.size() == total);
+        CHECK(store.diskUsage() > 0);
+
+        // 62 flushes in base 3 need five tiers, each holding at most two runs
+        CHECK(store.runCount() > 0 && store.runCount() <= 10);
+        CHECK(runFilesOnDisk(200) == store.runCount());
+
+        // Found in the memtable and in runs of every tier
+        TransactionNode found;
+        for (size_t i = 0; i < total; ++i) {
+            if (!store.get(generateHash(std::to_string(i)), found) || found.amount != static_cast<double>(i)) {
+                CHECK(!"transaction lost");
+                break;
+            }
+        }
+        CHECK(!store.get(generateHash("missing"), found));
+
+        // A later put of the same hash wins, in the memtable and after it is flushed and merged
+        for (size_t i = 0; i < total; i += 7) {
+            store.put(makeTransaction(i, -1.0));
+        }
+        store.put(makeTransaction(3, -2.0));
+        store.put(makeTransaction(3, -3.0));
+        CHECK(store.get(generateHash("3"), found) && found.amount == -3.0);
+        for (size_t i = 0; i < 1000; ++i) {
+            store.put(makeTransaction(total + i, 0.0));
+        }
+        CHECK(store.get(generateHash("3"), found) && found.amount == -3.0);
+        CHECK(store.get(generateHash("14"), found) && found.amount == -1.0);
+        CHECK(store.get(generateHash("15"), found) && found.amount == 15.0);
+        CHECK(store.runCount() <= 12);
+
+        // One copy per hash, in hash order, with the newest values
+        size_t visited = 0;
+        bool ordered = true;
+        bool newest = true;
+        std::string previous;
+        store.forEach([&](const TransactionNode& transaction) {
+            ordered = ordered && (visited == 0 || previous < transaction.hash);
+            previous = transaction.hash;
+            size_t i = std::stoul(transaction.id);
+            double expected = i == 3 ? -3.0 : i >= total ? 0.0 : i % 7 == 0 ? -1.0 : static_cast<double>(i);
+            newest = newest && transaction.amount == expected;
+            ++visited;
+        });
+        CHECK(ordered);
+        CHECK(newest);
+        CHECK(visited == 2 * total);
+        CHECK(store.size() >= visited);
+
+        store.clear();
+        CHECK(store.size() == 0 && store.runCount() == 0 && store.diskUsage() == 0);
+        CHECK(runFilesOnDisk(400) == 0);
+        CHECK(!store.get(generateHash("15"), found));
+    }
+
+    // A run that can no longer be read is kept rather than merged away
+    void checkFailedCompaction() {
+        LsmStoreOptions options;
+        options.memtableLimit = 4;
+        options.tierFanout = 2;
+        LsmTransactionStore store(prefix, options);
+
+        for (size_t i = 0; i < 4; ++i) {
+            store.put(makeTransaction(i, 1.0));
+        }
+        CHECK(store.runCount() == 1);
+        std::ofstream(prefix + ".run0", std::ios::trunc);
+
+        for (size_t i = 4; i < 8; ++i) {
+            store.put(makeTransaction(i, 1.0));
+        }
+        CHECK(store.runCount() == 2);
+        CHECK(store.size() == 8);
+        CHECK(runFilesOnDisk(10) == 2);  // Both inputs, and no partial output
+        TransactionNode found;
+        CHECK(store.get(generateHash("5"), found) && found.amount == 1.0);
+        store.clear();
+    }
+}
+
+int main() {
+    checkStore();
+    checkFailedCompaction();
+    return testResult();
+}
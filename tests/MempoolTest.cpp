@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "DAG.h"
+#include "Mempool.h"
+#include "TestSupport.h"
+
+namespace {
+    // Fixed-width fields, so priority is proportional to fee
+    TransactionNode makeTransaction(size_t id, double fee) {
+        TransactionNode transaction;
+        char name[16];
+        snprintf(name, sizeof(name), "tx%08zu", id);
+        transaction.id = name;
+        transaction.hash = name;
+        transaction.senderAcc = "alice";
+        transaction.receiverAcc = "bob";
+        transaction.amount = 10.0;
+        transaction.fee = fee;
+        return transaction;
+    }
+
+    // A full pool keeps the highest fees and drains them in descending order
+    void checkOrdering() {
+        DAG dag;
+        const size_t capacity = 64;
+        Mempool pool(dag, capacity, 1.0);
+
+        std::mt19937_64 rng(7);
+        std::uniform_real_distribution<double> fees(0.01, 100.0);
+        std::vector<double> submitted;
+        for (size_t i = 0; i < 500; ++i) {
+            double fee = fees(rng);
+            submitted.push_back(fee);
+            AdmissionResult result = pool.submit(makeTransaction(i, fee));
+            CHECK(result != AdmissionResult::Backpressure);
+            CHECK(pool.size() <= capacity);
+        }
+        CHECK(pool.size() == capacity);
+        CHECK(pool.admittedCount() == capacity + pool.evictedCount());
+        CHECK(pool.admittedCount() + pool.rejectedCount() == submitted.size());
+
+        std::sort(submitted.begin(), submitted.end(), std::greater<double>());
+        std::vector<double> drained;
+        while (pool.size() > 0) {
+            for (const auto& transaction : pool.drainBatch(5)) {
+                drained.push_back(transaction.fee);
+            }
+        }
+        CHECK(drained.size() == capacity);
+        CHECK(std::equal(drained.begin(), drained.end(), submitted.begin()));
+    }
+
+    // Interleaved submits and drains keep the heap consistent at every size
+    void checkInterleaved() {
+        DAG dag;
+        Mempool pool(dag, 1000, 1.0);
+        std::mt19937_64 rng(11);
+        std::uniform_real_distribution<double> fees(0.01, 100.0);
+        std::vector<double> pending;
+        size_t next = 0;
+        for (size_t round = 0; round < 200; ++round) {
+            for (size_t i = rng() % 8; i > 0; --i) {
+                double fee = fees(rng);
+                pending.push_back(fee);
+                CHECK(pool.submit(makeTransaction(next++, fee)) == AdmissionResult::Accepted);
+            }
+            std::sort(pending.begin(), pending.end(), std::greater<double>());
+            std::vector<TransactionNode> batch = pool.drainBatch(rng() % 6);
+            for (size_t i = 0; i < batch.size(); ++i) {
+                CHECK(batch[i].fee == pending[i]);
+            }
+            pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(batch.size()));
+            CHECK(pool.size() == pending.size());
+        }
+    }
+
+    void checkFeesAndBackpressure() {
+        DAG dag;
+        Mempool pool(dag, 4, 0.5);
+
+        // A sender's higher fee is kept; a missing one is charged the DAG's fee
+        CHECK(pool.submit(makeTransaction(0, 5.0)) == AdmissionResult::Accepted);
+        CHECK(pool.submit(makeTransaction(1, 0.0)) == AdmissionResult::Accepted);
+
+        // Above the watermark a transaction that does not outrank the minimum is not queued
+        CHECK(pool.submit(makeTransaction(2, 1e-9)) == AdmissionResult::Backpressure);
+        CHECK(pool.size() == 2);
+        CHECK(pool.rejectedCount() == 0);
+
+        std::vector<TransactionNode> batch = pool.drainBatch(2);
+        CHECK(batch.size() == 2);
+        bool sawKept = false;
+        bool sawCharged = false;
+        for (const auto& transaction : batch) {
+            sawKept = sawKept || (transaction.id == "tx00000000" && transaction.fee == 5.0);
+            sawCharged = sawCharged || (transaction.id == "tx00000001" && transaction.fee == dag.calculateFee(10.0));
+        }
+        CHECK(sawKept);
+        CHECK(sawCharged);
+
+        // An underpaying sender is raised to the DAG's fee
+        CHECK(pool.submit(makeTransaction(3, dag.calculateFee(10.0) / 100.0)) == AdmissionResult::Accepted);
+        std::vector<TransactionNode> raised = pool.drainBatch(1);
+        CHECK(raised.size() == 1 && raised[0].fee == dag.calculateFee(10.0));
+    }
+
+    // With no tips to walk to, the batch engine must not attach the whole batch as roots
+    void checkBatchOnEmptyDAG() {
+        DAG dag;
+        dag.setVerbose(false);
+        TipSelectionEngine engine(2);
+        Mempool pool(dag, 100, 1.0);
+        pool.setTipSelectionEngine(&engine);
+        for (size_t i = 0; i < 50; ++i) {
+            CHECK(pool.submit(makeTransaction(i, 1.0 + static_cast<double>(i))) == AdmissionResult::Accepted);
+        }
+        CHECK(pool.attachBatch(50) == 50);
+
+        size_t roots = 0;
+        for (const auto& pair : dag.getTransactions()) {
+            roots += pair.second.parentHashes.empty();
+        }
+        CHECK(roots == 1);
+
+        // Once there are tips, later batches go through the engine
+        for (size_t i = 50; i < 100; ++i) {
+            pool.submit(makeTransaction(i, 1.0));
+        }
+        uint64_t walks = engine.walkCount();
+        CHECK(pool.attachBatch(50) == 50);
+        CHECK(engine.walkCount() > walks);
+    }
+}
+
+int main() {
+    checkOrdering();
+    checkInterleaved();
+    checkFeesAndBackpressure();
+    checkBatchOnEmptyDAG();
+    return testResult();
+}
@@ -0,0 +1,85 @@
+#include <random>
+#include <vector>
+#include "ReachabilityIndex.h"
+#include "TestSupport.h"
+
+namespace {
+    // Random DAG whose parents are mostly recent, with some far back, so both
+    // the window bits and the search fallback get exercised
+    std::vector<std::vector<uint32_t>> randomDag(size_t nodes, uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::vector<std::vector<uint32_t>> parents(nodes);
+        for (uint32_t id = 1; id < nodes; ++id) {
+            size_t count = 1 + rng() % 3;
+            for (size_t i = 0; i < count; ++i) {
+                uint32_t span = rng() % 10 == 0 ? id : std::min<uint32_t>(id, 40);
+                parents[id].push_back(id - 1 - static_cast<uint32_t>(rng() % span));
+            }
+        }
+        return parents;
+    }
+
+    void checkAgainstClosure(size_t nodes, size_t window, uint64_t seed) {
+        std::vector<std::vector<uint32_t>> parents = randomDag(nodes, seed);
+
+        ReachabilityIndex index(window);
+        std::vector<std::vector<bool>> closure(nodes, std::vector<bool>(nodes, false));
+        for (uint32_t id = 0; id < nodes; ++id) {
+            CHECK(index.addNode(parents[id]) == id);
+            closure[id][id] = true;
+            for (uint32_t parent : parents[id]) {
+                for (uint32_t ancestor = 0; ancestor <= parent; ++ancestor) {
+                    if (closure[parent][ancestor]) {
+                        closure[id][ancestor] = true;
+                    }
+                }
+            }
+        }
+
+        for (uint32_t from = 0; from < nodes; ++from) {
+            size_t past = 0;
+            size_t future = 0;
+            for (uint32_t to = 0; to < nodes; ++to) {
+                CHECK(index.reaches(from, to) == closure[from][to]);
+                past += closure[from][to] && to != from;
+                future += closure[to][from] && to != from;
+            }
+            CHECK(index.countPastCone(from) == past);
+            CHECK(index.countFutureCone(from) == future);
+        }
+    }
+
+    void checkMemoryIsPerNode() {
+        ReachabilityIndex index;
+        std::vector<std::vector<uint32_t>> parents = randomDag(20000, 7);
+        size_t halfway = 0;
+        for (uint32_t id = 0; id < parents.size(); ++id) {
+            index.addNode(parents[id]);
+            if (id + 1 == parents.size() / 2) {
+                halfway = index.memoryUsage();
+            }
+        }
+        // Labels and links are a fixed size per node and edge; vector growth may double capacity
+        CHECK(index.memoryUsage() <= 4 * halfway);
+        CHECK(index.memoryUsage() / parents.size() <= 2 * (index.window() / 8 + 64));
+    }
+}
+
+int main() {
+    checkAgainstClosure(600, 64, 1);
+    checkAgainstClosure(600, 128, 2);
+    checkAgainstClosure(300, 1024, 3);
+    checkMemoryIsPerNode();
+
+    ReachabilityIndex index;
+    index.addNode({});
+    bool threw = false;
+    try {
+        index.addNode({ 5 });
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+    return testResult();
+}
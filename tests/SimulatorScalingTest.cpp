@@ -0,0 +1,28 @@
+#include "Simulator.h"
+#include "TestSupport.h"
+
+namespace {
+    // A delayed, orphan-heavy network, where parents picked at issue time are
+    // rarely still tips on arrival
+    double indexBytesPerTransaction(double duration) {
+        SimulationConfig config;
+        config.numIssuers = 2000;
+        config.issueRate = 0.2;
+        config.duration = duration;
+        Simulator simulator(config);
+        SimulationReport report = simulator.run();
+        CHECK(report.attached > 0);
+        return report.indexBytesPerTransaction;
+    }
+}
+
+// Per-transaction index memory must not grow with the length of the run. Labels
+// sized to the number of chains grew about linearly here; vector growth alone
+// accounts for at most a factor of two.
+int main() {
+    double shortRun = indexBytesPerTransaction(10.0);
+    double longRun = indexBytesPerTransaction(40.0);
+    std::cout << "Index bytes per transaction: " << shortRun << " (10s), " << longRun << " (40s)\n";
+    CHECK(longRun <= shortRun * 2.0);
+    return testResult();
+}
@@ -0,0 +1,29 @@
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <iostream>
+
+// Minimal checks for the test executables: failures are printed and counted,
+// and main returns testResult() so ctest sees a nonzero exit code.
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition "\n"; \
+            ++testFailures();                                                         \
+        }                                                                             \
+    } while (0)
+
+inline int testResult() {
+    if (testFailures() > 0) {
+        std::cerr << testFailures() << " check(s) failed\n";
+        return 1;
+    }
+    return 0;
+}
+
+#endif // TEST_SUPPORT_H
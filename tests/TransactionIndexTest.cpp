@@ -0,0 +1,119 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "TestSupport.h"
+#include "TransactionIndex.h"
+
+namespace {
+    // Transactions with random timestamps (many shared) between a few accounts; ids are indexes
+    std::vector<TransactionNode> makeTransactions(size_t count, uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::vector<TransactionNode> transactions(count);
+        for (size_t id = 0; id < count; ++id) {
+            TransactionNode& t = transactions[id];
+            t.id = std::to_string(id);
+            t.hash = "h" + t.id;
+            t.senderAcc = "account" + std::to_string(rng() % 8);
+            t.receiverAcc = rng() % 10 == 0 ? t.senderAcc : "account" + std::to_string(rng() % 8);
+            t.timestamp = static_cast<time_t>(1000 + rng() % 200);
+        }
+        return transactions;
+    }
+
+    // Every id except multiples of 'missing' resolves, as if those had been dropped
+    TransactionResolver resolverFor(const std::vector<TransactionNode>& transactions, size_t missing = 0) {
+        return [&transactions, missing](uint32_t id, TransactionNode& transaction) {
+            if (id >= transactions.size() || (missing != 0 && id % missing == 0)) {
+                return false;
+            }
+            transaction = transactions[id];
+            return true;
+        };
+    }
+
+    std::vector<uint32_t> drain(TransactionCursor cursor, size_t pageSize) {
+        std::vector<uint32_t> ids;
+        while (cursor.hasNext()) {
+            std::vector<TransactionNode> page = cursor.nextPage(pageSize);
+            CHECK(page.size() <= pageSize);
+            for (const auto& transaction : page) {
+                ids.push_back(static_cast<uint32_t>(std::stoul(transaction.id)));
+            }
+        }
+        return ids;
+    }
+
+    void checkTimeRange() {
+        std::vector<TransactionNode> transactions = makeTransactions(2000, 3);
+        TransactionIndex index;
+        for (uint32_t id = 0; id < transactions.size(); ++id) {
+            index.add(id, transactions[id]);
+        }
+
+        const time_t ranges[][2] = { { 1050, 1120 }, { 1000, 1199 }, { 1077, 1077 }, { 0, 999 }, { 1300, 1400 }, { 1120, 1050 } };
+        for (const auto& range : ranges) {
+            // Inclusive bounds, oldest first, equal timestamps in attach order
+            std::vector<uint32_t> expected;
+            for (time_t timestamp = range[0]; timestamp <= range[1]; ++timestamp) {
+                for (uint32_t id = 0; id < transactions.size(); ++id) {
+                    if (transactions[id].timestamp == timestamp) {
+                        expected.push_back(id);
+                    }
+                }
+            }
+            for (size_t pageSize : { size_t(1), size_t(7), size_t(5000), SIZE_MAX }) {
+                CHECK(drain(index.timeRange(range[0], range[1], resolverFor(transactions)), pageSize) == expected);
+            }
+        }
+
+        // Unresolvable ids are skipped without ending the walk early
+        std::vector<uint32_t> resolved = drain(index.timeRange(1000, 1199, resolverFor(transactions, 3)), 10);
+        CHECK(resolved.size() == transactions.size() - (transactions.size() + 2) / 3);
+    }
+
+    void checkAccounts() {
+        std::vector<TransactionNode> transactions = makeTransactions(2000, 5);
+        TransactionIndex index;
+        for (uint32_t id = 0; id < transactions.size(); ++id) {
+            index.add(id, transactions[id]);
+        }
+        CHECK(index.accountCount() == 8);
+
+        for (size_t account = 0; account < 8; ++account) {
+            std::string name = "account" + std::to_string(account);
+            // Newest first, a self transfer listed once
+            std::vector<uint32_t> expected;
+            for (uint32_t id = static_cast<uint32_t>(transactions.size()); id-- > 0;) {
+                if (transactions[id].senderAcc == name || transactions[id].receiverAcc == name) {
+                    expected.push_back(id);
+                }
+            }
+            CHECK(drain(index.account(name, SIZE_MAX, resolverFor(transactions)), 13) == expected);
+            CHECK(drain(index.account(name, SIZE_MAX, resolverFor(transactions)), SIZE_MAX) == expected);
+
+            // The limit keeps the newest entries
+            std::vector<uint32_t> newest(expected.begin(), expected.begin() + 25);
+            CHECK(drain(index.account(name, 25, resolverFor(transactions)), 10) == newest);
+            CHECK(drain(index.account(name, 0, resolverFor(transactions)), 10).empty());
+        }
+        CHECK(drain(index.account("nobody", SIZE_MAX, resolverFor(transactions)), 10).empty());
+
+        // A cursor keeps the entries it was created with while the index grows
+        const std::string& sender = transactions[1].senderAcc;
+        TransactionCursor cursor = index.account(sender, 5, resolverFor(transactions));
+        std::vector<TransactionNode> first = cursor.nextPage(2);
+        for (size_t i = 0; i < 100; ++i) {
+            index.add(1, transactions[1]);
+        }
+        std::vector<TransactionNode> rest = cursor.nextPage(10);
+        CHECK(first.size() == 2 && rest.size() == 3 && !cursor.hasNext());
+        CHECK(rest.back().id != "1");
+    }
+}
+
+int main() {
+    checkTimeRange();
+    checkAccounts();
+    return testResult();
+}